@@ -10,6 +10,9 @@
  * Features:
  * 1. Answers Query about LCA of two nodes in O(log N)
  *          where N is the total number of nodes in a tree.
+ * 2. EulerTourLCA answers in O(1) after O(N log N) preprocessing,
+ *          using the DFS order and a sparse table, with flat storage,
+ *          a batch query API and an iterative DFS for deep trees.
  *
  * https://en.wikipedia.org/wiki/Lowest_common_ancestor
  * http://www.csegeek.com/csegeek/view/tutorials/algorithms/trees/tree_part12.php
@@ -18,6 +21,8 @@
 #ifndef LCA_H
 #define LCA_H
 #include <vector>
+#include <utility>
+#include "sparse_table.h"
 
 class LCA
 {
@@ -35,4 +40,102 @@ class LCA
         int _numberOfNodes, _maxLog;
 };
 
+/**
+ * O(1) LCA.
+ *
+ * With the nodes numbered in DFS preorder, for u != v with
+ * tin[u] < tin[v], the LCA is the parent of the node in
+ * (tin[u], tin[v]] whose parent comes first in preorder. This is the
+ * Euler tour reduction to RMQ with N - 1 entries instead of 2N - 1.
+ */
+class EulerTourLCA
+{
+    public:
+        EulerTourLCA(int numberOfNodes, const std::vector< std::pair<int,int> > &edges, int root = 0)
+            : _numberOfNodes(numberOfNodes), tin(numberOfNodes), order(numberOfNodes),
+              parent(numberOfNodes, -1), nodeDepth(numberOfNodes, 0)
+        {
+            buildAdjacency(edges);
+            if(numberOfNodes == 0) return;     // an empty tree, nothing to query
+            dfs(root);
+
+            // key[i] = preorder number of the parent of the i-th visited node
+            std::vector<int> key(numberOfNodes);
+            key[0] = -1;
+            for(int i = 1; i < numberOfNodes; i++) key[i] = tin[parent[order[i]]];
+            table.build(&key[0], numberOfNodes);
+        }
+
+        int lcaQuery(int a, int b) const
+        {
+            if(a == b) return a;
+            int l = tin[a], r = tin[b];
+            if(l > r) std::swap(l, r);
+            return order[table.query(l + 1, r + 1)];
+        }
+
+        void lcaQuery(const int a[], const int b[], int count, int result[]) const
+        {
+            for(int i = 0; i < count; i++) result[i] = lcaQuery(a[i], b[i]);
+        }
+
+        int depth(int a) const { return nodeDepth[a]; }
+
+        // number of edges on the path between a and b
+        int distance(int a, int b) const
+        {
+            return nodeDepth[a] + nodeDepth[b] - 2 * nodeDepth[lcaQuery(a, b)];
+        }
+
+    private:
+        /**
+         * Adjacency in CSR form: the neighbours of u are
+         * adjacency[offset[u] .. offset[u + 1]).
+         */
+        void buildAdjacency(const std::vector< std::pair<int,int> > &edges)
+        {
+            offset.assign(_numberOfNodes + 1, 0);
+            for(size_t i = 0; i < edges.size(); i++) {
+                offset[edges[i].first + 1]++;
+                offset[edges[i].second + 1]++;
+            }
+            for(int i = 0; i < _numberOfNodes; i++) offset[i + 1] += offset[i];
+            adjacency.resize(offset[_numberOfNodes]);
+            std::vector<int> pos(offset.begin(), offset.end() - 1);
+            for(size_t i = 0; i < edges.size(); i++) {
+                adjacency[pos[edges[i].first]++] = edges[i].second;
+                adjacency[pos[edges[i].second]++] = edges[i].first;
+            }
+        }
+
+        /**
+         * Preorder DFS with an explicit stack, no recursion.
+         */
+        void dfs(int root)
+        {
+            std::vector<int> stack;
+            stack.reserve(_numberOfNodes);
+            stack.push_back(root);
+            int timer = 0;
+            while(!stack.empty()) {
+                int u = stack.back();
+                stack.pop_back();
+                tin[u] = timer;
+                order[timer++] = u;
+                for(int i = offset[u]; i < offset[u + 1]; i++) {
+                    int v = adjacency[i];
+                    if(v == parent[u]) continue;
+                    parent[v] = u;
+                    nodeDepth[v] = nodeDepth[u] + 1;
+                    stack.push_back(v);
+                }
+            }
+        }
+
+        int _numberOfNodes;
+        std::vector<int> offset, adjacency;
+        std::vector<int> tin, order, parent, nodeDepth;
+        alg::SparseTable<int> table;
+};
+
 #endif // LCA_H
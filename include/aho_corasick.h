@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * AHO-CORASICK MULTI-PATTERN MATCHING
+ *
+ * Features:
+ * 1. all the occurrences of any number of byte patterns (NULs allowed) in
+ *    one pass over the text, O(n + matches) whatever the pattern count.
+ * 2. the automaton is a complete DFA in one flat table: a row per state,
+ *    a column per byte class (the bytes of the patterns, the others share
+ *    one class), the failure links folded in. a step is two loads:
+ *    class[byte], then the row; a bit of the entry tells a state with
+ *    matches, the scan loop has no other branch.
+ * 3. the states are numbered breadth first, the shallow ones that most
+ *    bytes visit share the first rows.
+ * 4. Stream keeps the state between the buffers, a match across a chunk
+ *    boundary is found like any other, at its absolute position.
+ *
+ * The table takes 4 * states * classes bytes.
+ *
+ * http://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_algorithm
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_AHO_CORASICK_H__
+#define ALGO_AHO_CORASICK_H__
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+namespace alg {
+	class AhoCorasick {
+		private:
+			enum {
+				MATCH = 0x80000000u,	// in an entry: the target state has matches
+				NONE = 0xffffffffu
+			};
+
+			uint32_t m_nclass;
+			uint8_t m_class[256];				// byte -> column
+			std::vector<uint32_t> m_delta;		// the rows, entries are row offsets | MATCH
+			// the patterns ending at a state: m_out[m_out_first[s] .. m_out_first[s + 1])
+			std::vector<uint32_t> m_out_first, m_out;
+			std::vector<uint32_t> m_out_link;	// the next state down the failure links with patterns
+			std::vector<uint32_t> m_length;		// of the patterns
+
+		public:
+			struct Match {
+				uint32_t pattern;		// its index in the list
+				uint64_t pos;			// where it starts
+			};
+
+			/**
+			 * the automaton of the patterns, none empty
+			 */
+			explicit AhoCorasick(const std::vector<std::string> & patterns) : m_nclass(1) {
+				build(patterns);
+			}
+
+			uint32_t state_count() const { return (uint32_t)m_out_link.size(); }
+			uint32_t pattern_count() const { return (uint32_t)m_length.size(); }
+
+			/**
+			 * the memory of the automaton, in bytes
+			 */
+			size_t bytes() const {
+				return (m_delta.size() + m_out_first.size() + m_out.size() + m_out_link.size() + m_length.size()) *
+					sizeof(uint32_t) + sizeof(m_class);
+			}
+
+			/**
+			 * the matching over a stream of buffers
+			 */
+			class Stream {
+				private:
+					const AhoCorasick & m_ac;
+					uint32_t m_row;			// the current state, as a row offset
+					uint64_t m_offset;		// bytes fed so far
+
+				public:
+					explicit Stream(const AhoCorasick & ac) : m_ac(ac), m_row(0), m_offset(0) {}
+
+					/**
+					 * the next buffer: appends its matches to out, those that
+					 * end in it, by end then the longest first. returns their
+					 * number.
+					 */
+					size_t feed(const void * buf, size_t n, std::vector<Match> & out) {
+						const uint8_t * p = (const uint8_t *)buf;
+						const uint8_t * cls = m_ac.m_class;
+						const uint32_t * delta = &m_ac.m_delta[0];
+						size_t before = out.size();
+						uint32_t row = m_row;
+						for (size_t i = 0; i < n; i++) {
+							uint32_t e = delta[row + cls[p[i]]];
+							row = e & ~(uint32_t)MATCH;
+							if (e & MATCH) m_ac.report(row, m_offset + i + 1, out);
+						}
+						m_row = row;
+						m_offset += n;
+						return out.size() - before;
+					}
+
+					/**
+					 * back to the start of a stream
+					 */
+					void reset() {
+						m_row = 0;
+						m_offset = 0;
+					}
+
+					uint64_t offset() const { return m_offset; }
+			};
+
+			/**
+			 * all the matches in text[0..n)
+			 */
+			size_t find_all(const void * text, size_t n, std::vector<Match> & out) const {
+				out.clear();
+				Stream s(*this);
+				return s.feed(text, n, out);
+			}
+			size_t find_all(const std::string & text, std::vector<Match> & out) const {
+				return find_all(text.data(), text.size(), out);
+			}
+
+		private:
+			/**
+			 * the patterns that end at end in the state of row
+			 */
+			void report(uint32_t row, uint64_t end, std::vector<Match> & out) const {
+				for (uint32_t s = row / m_nclass; s != NONE; s = m_out_link[s]) {
+					for (uint32_t k = m_out_first[s]; k < m_out_first[s + 1]; k++) {
+						Match m = {m_out[k], end - m_length[m_out[k]]};
+						out.push_back(m);
+					}
+				}
+			}
+
+			struct PatternLess {
+				const std::vector<std::string> & p;
+				explicit PatternLess(const std::vector<std::string> & p) : p(p) {}
+				bool operator()(uint32_t a, uint32_t b) const {
+					return p[a] < p[b] || (p[a] == p[b] && a < b);
+				}
+			};
+
+			void build(const std::vector<std::string> & patterns) {
+				// the byte classes: 0 for the bytes of no pattern
+				bool used[256] = {false};
+				size_t total = 0;
+				m_length.resize(patterns.size());
+				for (size_t i = 0; i < patterns.size(); i++) {
+					if (patterns[i].empty()) throw std::invalid_argument("empty pattern");
+					if (patterns[i].size() >= UINT32_MAX) throw std::length_error("pattern too long");
+					m_length[i] = (uint32_t)patterns[i].size();
+					total += patterns[i].size();
+					for (size_t k = 0; k < patterns[i].size(); k++) used[(uint8_t)patterns[i][k]] = true;
+				}
+				m_nclass = 1;
+				for (int b = 0; b < 256; b++) m_class[b] = used[b] ? (uint8_t)m_nclass++ : 0;
+				if ((total + 1) * m_nclass >= MATCH) throw std::length_error("automaton too large");
+
+				// the trie, a level at a time over the sorted patterns: the
+				// states come out breadth first. a pattern leaves the list
+				// once it ends, O(total length) in all. the entries are
+				// state ids until the end.
+				const uint32_t C = m_nclass;
+				std::vector<uint32_t> order(patterns.size());
+				for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+				std::sort(order.begin(), order.end(), PatternLess(patterns));
+				std::vector<uint32_t> at(patterns.size(), 0);
+				m_delta.assign(C, (uint32_t)NONE);
+				uint32_t nstates = 1;
+				for (size_t d = 0; !order.empty(); d++) {
+					size_t live = 0;
+					for (size_t k = 0; k < order.size(); k++) {
+						const std::string & p = patterns[order[k]];
+						uint32_t & next = m_delta[(size_t)at[order[k]] * C + m_class[(uint8_t)p[d]]];
+						if (next == NONE) {
+							next = nstates++;
+							m_delta.resize((size_t)nstates * C, (uint32_t)NONE);
+						}
+						at[order[k]] = m_delta[(size_t)at[order[k]] * C + m_class[(uint8_t)p[d]]];
+						if (d + 1 < p.size()) order[live++] = order[k];
+					}
+					order.resize(live);
+				}
+
+				// the patterns of every state, ascending
+				m_out_first.assign(nstates + 1, 0);
+				for (size_t i = 0; i < patterns.size(); i++) m_out_first[at[i] + 1]++;
+				for (uint32_t s = 0; s < nstates; s++) m_out_first[s + 1] += m_out_first[s];
+				m_out.resize(patterns.size());
+				std::vector<uint32_t> fill(m_out_first.begin(), m_out_first.end() - 1);
+				for (uint32_t i = 0; i < patterns.size(); i++) m_out[fill[at[i]]++] = i;
+
+				// failure links in state order, which is breadth first: a
+				// missing edge takes the one of the failure state
+				std::vector<uint32_t> fail(nstates, 0);
+				m_out_link.assign(nstates, (uint32_t)NONE);
+				for (uint32_t u = 0; u < nstates; u++) {
+					uint32_t * row = &m_delta[(size_t)u * C];
+					const uint32_t * frow = &m_delta[(size_t)fail[u] * C];
+					for (uint32_t c = 0; c < C; c++) {
+						if (row[c] == NONE) {
+							row[c] = u == 0 ? 0 : frow[c];
+						} else {
+							uint32_t v = row[c];
+							fail[v] = u == 0 ? 0 : frow[c];
+							uint32_t f = fail[v];
+							m_out_link[v] = m_out_first[f] < m_out_first[f + 1] ? f : m_out_link[f];
+						}
+					}
+				}
+
+				// state ids to row offsets, with the flag of the states that match
+				for (size_t i = 0; i < m_delta.size(); i++) {
+					uint32_t v = m_delta[i];
+					bool match = m_out_first[v] < m_out_first[v + 1] || m_out_link[v] != NONE;
+					m_delta[i] = v * C | (match ? (uint32_t)MATCH : 0);
+				}
+			}
+	};
+}
+
+#endif //
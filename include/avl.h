@@ -11,6 +11,8 @@
  * 1. Guaranteed search time is O(log(N)).
  * 2. Dynamically updated/balanced tree structure O(N) storage.
  * 3. Exportable to GraphViz format for easy visualization and verification
+ * 4. Nodes are allocated from a node pool, the whole tree is freed at once
+ * 5. O(N) bulk construction from sorted input
  *
  * http://en.wikipedia.org/wiki/AVL_tree
  * 
@@ -27,6 +29,11 @@
 #include <stack>
 #include <algorithm>
 #include <string>
+#include <stdexcept>
+#if __cplusplus >= 201103L
+#include <type_traits>
+#endif
+#include "node_pool.h"
 
 namespace alg {
 
@@ -36,6 +43,7 @@ class AVL {
     public:
 
         AVL() : tree(0), numNodes(0) {}
+        ~AVL() { clear(); }
 
         T root () const           { return tree->value; }
         unsigned height() const   { return Node::getHeight(tree); }
@@ -49,19 +57,43 @@ class AVL {
         }
 
         void insert(const T &x) {
-            if (isEmpty()) tree = new Node(x);
-            else tree = tree->insert(x);
+            if (isEmpty()) tree = new (pool.alloc()) Node(x);
+            else tree = tree->insert(x, pool);
             numNodes++;
         }
 
         void erase(const T &x) {
             if (!isEmpty()) {
                 bool found = false;
-                tree = tree->erase(x, found);
+                tree = tree->erase(x, found, pool);
                 if (found) numNodes--;
             }
         }
 
+        // Removes every element, the node pool is released as a whole
+        void clear() {
+#if __cplusplus >= 201103L
+            if (!std::is_trivially_destructible<T>::value)
+#endif
+                destruct(tree);
+            pool.release();
+            tree = 0;
+            numNodes = 0;
+        }
+
+        // Replaces the tree with n sorted values in O(N)
+        void build_from_sorted(const T values[], unsigned n) {
+            for (unsigned i = 1; i < n; ++i) {
+                if (values[i] < values[i-1])
+                    throw std::invalid_argument("values are not sorted");
+            }
+
+            clear();
+            pool.reserve(n);
+            tree = build(values, 0, (long)n - 1);
+            numNodes = n;
+        }
+
         void toGraphViz(std::ostream &stream, std::string name) const {
             if (!isEmpty()) {
                 stream << "digraph " << name << " {" << std::endl;
@@ -86,33 +118,33 @@ class AVL {
                 else return false;
             }
 
-            Node *insert(const T &x) {
+            Node *insert(const T &x, NodePool<Node> &pool) {
                 if (x <= value) {
-                    if (left == 0) left = new Node(x);
-                    else left = left->insert(x);
+                    if (left == 0) left = new (pool.alloc()) Node(x);
+                    else left = left->insert(x, pool);
                 }
                 else {
-                    if (right == 0) right = new Node(x);
-                    else right = right->insert(x);
+                    if (right == 0) right = new (pool.alloc()) Node(x);
+                    else right = right->insert(x, pool);
                 }
 
                 return update();
             }
 
-            Node *erase(const T &x, bool &found) {
+            Node *erase(const T &x, bool &found, NodePool<Node> &pool) {
                 if (value == x) {
                     found = true;
                     if (left == 0 && right == 0) {
-                        delete this;
+                        destroy(this, pool);
                         return 0;
                     } else if (left == 0) {
                         Node *aux = right;
                         *this = *right;
-                        delete aux;
+                        destroy(aux, pool);
                     } else if (right == 0) {
                         Node *aux = left;
                         *this = *left;
-                        delete aux;
+                        destroy(aux, pool);
                     } else {
                         // Tracing path to rightmost leaf of the left subtree
                         std::stack<Node*> trace;
@@ -126,7 +158,7 @@ class AVL {
                         current = trace.top();
                         value = current->value;
                         Node *lsubtree = current->left;
-                        delete current;
+                        destroy(current, pool);
                         trace.pop();
 
                         if (trace.empty()) { left = lsubtree; }
@@ -138,19 +170,20 @@ class AVL {
                                 current->right = current->right->update();
                                 trace.pop();
                             }
+                            left = left->update();
                         }
                     }
                     return update();
                 }
                 else if (x < value) {
                     if (left != 0) {
-                        left = left->erase(x, found);
+                        left = left->erase(x, found, pool);
                         return update();
                     } else return this;
                 }
                 else {
                     if (right != 0) {
-                        right = right->erase(x, found);
+                        right = right->erase(x, found, pool);
                         return update();
                     } else return this;
                 }
@@ -218,6 +251,11 @@ class AVL {
                 return t == 0 ? 0 : t->height;
             }
 
+            static void destroy(Node *t, NodePool<Node> &pool) {
+                t->~Node();
+                pool.free(t);
+            }
+
             void toGraphViz(std::ostream &stream) const {
                 stream << value << ";" << std::endl;
                 if (left != 0) {
@@ -235,6 +273,29 @@ class AVL {
 
         Node *tree;
         unsigned numNodes;
+
+    private:
+        NodePool<Node> pool;
+
+        AVL(const AVL &);
+        AVL& operator=(const AVL &);
+
+        static void destruct(Node *t) {
+            if (t == 0) return;
+            destruct(t->left);
+            destruct(t->right);
+            t->~Node();
+        }
+
+        Node *build(const T values[], long lo, long hi) {
+            if (lo > hi) return 0;
+            long mid = lo + (hi - lo) / 2;
+            Node *t = new (pool.alloc()) Node(values[mid]);
+            t->left = build(values, lo, mid - 1);
+            t->right = build(values, mid + 1, hi);
+            t->updateHeight();
+            return t;
+        }
 };
 
 }       // namespace alg
@@ -40,7 +40,21 @@
  *       if u.distance + uv.weight < v.distance:
  *           error "Graph contains a negative-weight cycle"
  * 
+ * Implementations over a CSRGraph, distances & parents in dense arrays:
+ * - SPFA: the queue based variant, a vertex is scanned again only when its
+ *   distance dropped, and it stops as soon as nothing changes. a negative
+ *   cycle shows up as a cycle of the parent pointers, which are checked
+ *   after every V relaxations; the cycle itself is returned.
+ *   run_all() starts every vertex at 0, to find a negative cycle anywhere
+ *   (arbitrage). update() takes the edges whose weights changed, and
+ *   resumes from the previous labels instead of starting over.
+ * - parallel_bellman_ford (C++11): synchronous rounds on nthreads threads.
+ *   each vertex pulls the minimum over its in-edges, only when an
+ *   in-neighbour changed in the last round; stops on a round without change.
+ *
  * http://en.wikipedia.org/wiki/Bellman%E2%80%93Ford_algorithm
+ * http://en.wikipedia.org/wiki/Shortest_Path_Faster_Algorithm
+ * Cherkassky & Goldberg, Negative-cycle detection algorithms, 1999
  * 
  ******************************************************************************/
 
@@ -52,79 +66,368 @@
 #include <limits.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <vector>
+#include <algorithm>
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#endif
 
 #include "directed_graph.h"
 #include "hash_table.h"
+#include "csr_graph.h"
 
 // define UNDEFINED previous vertex.
 #define UNDEFINED -1
 
 namespace alg {
-	class BellmanFord {
-		private:		
-			HashTable<int32_t, int32_t> dist; 		// hash table for distance.
-			bool has_neg_cycle;				// negative weighted cycle mark.
-			const Graph & g;	
+	static const uint32_t BF_NONE = UINT32_MAX;
+	static const int64_t BF_INF = INT64_MAX;
+
+	namespace detail {
+		/**
+		 * look for a cycle of the parent pointers, walking up from every
+		 * vertex. seen[v] is the walk v was met by, epoch the last walk.
+		 * returns a vertex on a cycle, or BF_NONE.
+		 */
+		static uint32_t parent_cycle(const std::vector<uint32_t> & prev,
+				std::vector<uint32_t> & seen, uint32_t & epoch) {
+			uint32_t n = (uint32_t)prev.size();
+			if (epoch > UINT32_MAX - n - 1) {
+				std::fill(seen.begin(), seen.end(), 0);
+				epoch = 0;
+			}
+			uint32_t base = epoch + 1;
+			for (uint32_t s = 0; s < n; s++) {
+				if (seen[s] >= base) continue;
+				uint32_t walk = ++epoch;
+				uint32_t v = s;
+				while (v != BF_NONE && seen[v] < base) {
+					seen[v] = walk;
+					v = prev[v];
+				}
+				if (v != BF_NONE && seen[v] == walk) return v;
+			}
+			return BF_NONE;
+		}
+
+		/**
+		 * the cycle through c of the parent pointers, in edge order
+		 */
+		static void parent_cycle_path(const std::vector<uint32_t> & prev, uint32_t c,
+				std::vector<uint32_t> & cycle) {
+			cycle.clear();
+			uint32_t v = c;
+			do {
+				cycle.push_back(v);
+				v = prev[v];
+			} while (v != c);
+			std::reverse(cycle.begin(), cycle.end());
+		}
+	}
+
+	/**
+	 * queue based Bellman-Ford (SPFA)
+	 */
+	class SPFA {
+		private:
+			const CSRGraph & g;
+			std::vector<int64_t> m_dist;
+			std::vector<uint32_t> m_prev;		// parent on the shortest path tree, BF_NONE at a root
+			std::vector<uint32_t> m_edge;		// the edge from the parent
+			std::vector<uint32_t> m_cycle;
+			std::vector<uint32_t> m_queue;		// FIFO, a ring of V slots
+			std::vector<uint8_t> m_inq;
+			uint32_t m_head, m_count;
+			std::vector<uint32_t> m_seen;		// for the parent cycle check
+			uint32_t m_epoch;
+			bool m_valid;						// the labels are final
+			uint32_t m_src;						// BF_NONE for run_all
+
 		public:
-			BellmanFord(const Graph & graph):
-				dist(graph.vertex_count()),g(graph) { }
+			explicit SPFA(const CSRGraph & graph) : g(graph), m_head(0), m_count(0),
+				m_epoch(0), m_valid(false), m_src(BF_NONE) {}
 
 			/**
-			 * Bellman-Ford algorithm
+			 * shortest paths from src. returns false when a negative cycle
+			 * is reachable from src, see cycle().
 			 */
-			HashTable<int32_t, int32_t> * run(uint32_t source) {
-				// hash table for previous vertex
-				HashTable<int32_t, int32_t> *  previous = new HashTable<int32_t, int32_t>(g.vertex_count()); 
-				// source vertex
-				dist[source] = 0;
-
-				// other vertices
-				Graph::Adjacent * a;
-				list_for_each_entry(a, &g.list(), a_node){
-					if (source != a->v.id) {
-						dist[a->v.id] = INT_MAX;
-					}
-					(*previous)[a->v.id] = UNDEFINED;
+			bool run(uint32_t src) {
+				init(src, BF_INF);
+				m_dist[src] = 0;
+				push(src);
+				return relax();
+			}
+
+			/**
+			 * every vertex starts at distance 0, as if joined to a virtual
+			 * source. returns false when the graph has a negative cycle.
+			 */
+			bool run_all() {
+				uint32_t n = g.vertex_count();
+				init(BF_NONE, 0);
+				for (uint32_t v = 0; v < n; v++) push(v);
+				return relax();
+			}
+
+			/**
+			 * the weights of the k edges changed (CSRGraph::set_weight) since
+			 * the last run. resumes from the previous labels, unless an edge
+			 * of the shortest path tree got heavier, or the last run ended on
+			 * a negative cycle: then it starts over.
+			 */
+			bool update(const uint32_t edges[], uint32_t k) {
+				bool restart = !m_valid;
+				for (uint32_t i = 0; i < k && !restart; i++) {
+					uint32_t e = edges[i], u = g.source(e), v = g.target(e);
+					if (m_edge[v] == e && m_dist[v] < m_dist[u] + g.weight(e)) restart = true;
 				}
+				if (restart) return m_src == BF_NONE ? run_all() : run(m_src);
 
-				has_neg_cycle = false;	// negative cycle mark set to 'false'.
+				for (uint32_t i = 0; i < k; i++) {
+					uint32_t e = edges[i], u = g.source(e), v = g.target(e);
+					if (m_dist[u] != BF_INF && m_dist[u] + g.weight(e) < m_dist[v] && !m_inq[u]) push(u);
+				}
+				return relax();
+			}
 
-				//  relax edges repeatedly	
-				Graph::Adjacent * u;
-				for (uint32_t i=0;i<g.vertex_count()-1;i++) {    // loop |V| -1 times
-					list_for_each_entry(u, &g.list(), a_node){ // for each eage(u,v) in edges
-						int32_t dist_u = dist[u->v.id];
+			/**
+			 * the distance of v, BF_INF if unreachable
+			 */
+			inline int64_t dist(uint32_t v) const { return m_dist[v]; }
+			/**
+			 * the vertex before v on its shortest path, BF_NONE if none
+			 */
+			inline uint32_t prev(uint32_t v) const { return m_prev[v]; }
+			/**
+			 * the edge into v on its shortest path, BF_NONE if none
+			 */
+			inline uint32_t prev_edge(uint32_t v) const { return m_edge[v]; }
+			const std::vector<int64_t> & distances() const { return m_dist; }
 
-						Graph::Vertex * v;
-						list_for_each_entry(v, &u->v_head, v_node){ 
-							int32_t dist_v = dist[v->id];
+			/**
+			 * the negative cycle found by the last run, vertices in edge
+			 * order, the last one leads back to the first.
+			 */
+			const std::vector<uint32_t> & cycle() const { return m_cycle; }
 
-							if (dist_u + v->weight < dist_v) {
-								dist[v->id] = dist_u + v->weight;
-								(*previous)[v->id] = u->v.id;
+		private:
+			void init(uint32_t src, int64_t d) {
+				uint32_t n = g.vertex_count();
+				m_src = src;
+				m_dist.assign(n, d);
+				m_prev.assign(n, BF_NONE);
+				m_edge.assign(n, BF_NONE);
+				m_queue.resize(n);
+				m_inq.assign(n, 0);
+				m_seen.resize(n);
+				m_head = m_count = 0;
+				m_cycle.clear();
+			}
+
+			inline void push(uint32_t v) {
+				uint32_t n = (uint32_t)m_queue.size();
+				uint32_t tail = m_head + m_count;
+				m_queue[tail >= n ? tail - n : tail] = v;
+				m_count++;
+				m_inq[v] = 1;
+			}
+
+			bool relax() {
+				uint32_t n = g.vertex_count();
+				const uint32_t * offset = g.offsets();
+				const uint32_t * target = g.targets();
+				const int32_t * weight = g.weights();
+				uint32_t relaxed = 0;
+				m_cycle.clear();
+				m_valid = false;
+				while (m_count > 0) {
+					uint32_t u = m_queue[m_head];
+					m_head = m_head + 1 == n ? 0 : m_head + 1;
+					m_count--;
+					m_inq[u] = 0;
+					int64_t du = m_dist[u];
+					for (uint32_t e = offset[u]; e < offset[u + 1]; e++) {
+						uint32_t v = target[e];
+						int64_t d = du + (weight ? weight[e] : 1);
+						if (d >= m_dist[v]) continue;
+						m_dist[v] = d;
+						m_prev[v] = u;
+						m_edge[v] = e;
+						if (!m_inq[v]) push(v);
+
+						if (++relaxed == n) {
+							relaxed = 0;
+							uint32_t c = detail::parent_cycle(m_prev, m_seen, m_epoch);
+							if (c != BF_NONE) {
+								detail::parent_cycle_path(m_prev, c, m_cycle);
+								for (; m_count > 0; m_count--) {
+									m_inq[m_queue[m_head]] = 0;
+									m_head = m_head + 1 == n ? 0 : m_head + 1;
+								}
+								return false;
 							}
 						}
 					}
 				}
+				m_valid = true;
+				return true;
+			}
+	};
+
+#if __cplusplus >= 201103L
+	namespace detail {
+		class BFBarrier {
+			private:
+				std::mutex mu;
+				std::condition_variable cv;
+				int m_n, m_waiting;
+				uint64_t m_gen;
+			public:
+				explicit BFBarrier(int n) : m_n(n), m_waiting(0), m_gen(0) {}
+				void wait() {
+					std::unique_lock<std::mutex> lk(mu);
+					uint64_t gen = m_gen;
+					if (++m_waiting == m_n) {
+						m_waiting = 0;
+						m_gen++;
+						cv.notify_all();
+						return;
+					}
+					while (gen == m_gen) cv.wait(lk);
+				}
+		};
+	}
 
-				//  check for negative-weight cycles
-				list_for_each_entry(u, &g.list(), a_node) {
-					int32_t dist_u = dist[u->v.id];
+	/**
+	 * Bellman-Ford by synchronous rounds on nthreads threads. dist[v] is
+	 * the distance from src or BF_INF, prev[v] the vertex before v or
+	 * BF_NONE. returns false on a negative cycle reachable from src, which
+	 * is stored in *cycle when given.
+	 */
+	static bool parallel_bellman_ford(const CSRGraph & g, uint32_t src, std::vector<int64_t> & dist,
+			std::vector<uint32_t> & prev, std::vector<uint32_t> * cycle = NULL, int nthreads = 0) {
+		const uint32_t CHECK_ROUNDS = 16;		// parent cycle check period
+		if (nthreads <= 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+		uint32_t n = g.vertex_count();
+		CSRGraph gt = g.transpose();
+		dist.assign(n, BF_INF);
+		prev.assign(n, BF_NONE);
+		if (cycle) cycle->clear();
 
-					Graph::Vertex * v;
-					list_for_each_entry(v, &u->v_head, v_node){
-						int32_t dist_v = dist[v->id];
+		std::vector<int64_t> next(n);
+		std::vector<uint8_t> changed(n, 0);
+		std::unique_ptr<std::atomic<uint8_t>[]> dirty(new std::atomic<uint8_t>[n]);
+		for (uint32_t v = 0; v < n; v++) dirty[v].store(0, std::memory_order_relaxed);
+		dist[src] = 0;
+		for (uint32_t e = g.begin(src); e < g.end(src); e++) dirty[g.target(e)].store(1, std::memory_order_relaxed);
 
-						if (dist_u + v->weight < dist_v) {
-							has_neg_cycle = true;	// graph contains a negative-weight cycle
-							return previous;
+		std::atomic<uint32_t> nchanged(0);
+		detail::BFBarrier barrier(nthreads);
+		std::vector<uint32_t> seen(n);
+		uint32_t epoch = 0, round = 0, found = BF_NONE;
+		bool stop = false;
+
+		std::vector<std::thread> workers;
+		auto work = [&](int t) {
+			uint32_t begin = (uint64_t)n * t / nthreads, end = (uint64_t)n * (t + 1) / nthreads;
+			for (;;) {
+				// pull the labels of the last round over the in-edges
+				uint32_t count = 0;
+				for (uint32_t v = begin; v < end; v++) {
+					changed[v] = 0;
+					if (!dirty[v].load(std::memory_order_relaxed)) continue;
+					dirty[v].store(0, std::memory_order_relaxed);
+					int64_t best = dist[v];
+					uint32_t p = prev[v];
+					for (uint32_t f = gt.begin(v); f < gt.end(v); f++) {
+						int64_t du = dist[gt.target(f)];
+						if (du == BF_INF) continue;
+						int64_t d = du + gt.weight(f);
+						if (d < best) {
+							best = d;
+							p = gt.target(f);
 						}
-					}	
+					}
+					if (best < dist[v]) {
+						next[v] = best;
+						prev[v] = p;
+						changed[v] = 1;
+						count++;
+					}
+				}
+				nchanged.fetch_add(count, std::memory_order_relaxed);
+				barrier.wait();
+				if (nchanged.load(std::memory_order_relaxed) == 0) return;
+
+				// publish, and wake up the out-neighbours
+				for (uint32_t v = begin; v < end; v++) {
+					if (!changed[v]) continue;
+					dist[v] = next[v];
+					for (uint32_t e = g.begin(v); e < g.end(v); e++) dirty[g.target(e)].store(1, std::memory_order_relaxed);
 				}
+				barrier.wait();
+				if (t == 0) {
+					nchanged.store(0, std::memory_order_relaxed);
+					// V rounds with change prove a negative cycle
+					if (++round % CHECK_ROUNDS == 0 || round >= n) {
+						found = detail::parent_cycle(prev, seen, epoch);
+						stop = found != BF_NONE;
+					}
+				}
+				barrier.wait();
+				if (stop) return;
+			}
+		};
+		for (int t = 1; t < nthreads; t++) workers.push_back(std::thread(work, t));
+		work(0);
+		for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+
+		if (found == BF_NONE) return true;
+		if (cycle) detail::parent_cycle_path(prev, found, *cycle);
+		return false;
+	}
+#endif
 
+	/**
+	 * Bellman-Ford over a Graph, on top of SPFA
+	 */
+	class BellmanFord {
+		private:		
+			bool has_neg_cycle;				// negative weighted cycle mark.
+			const Graph & g;	
+		public:
+			BellmanFord(const Graph & graph):
+				has_neg_cycle(false), g(graph) { }
+
+			/**
+			 * Bellman-Ford algorithm, returns the previous vertex of every
+			 * vertex on its shortest path from source, or UNDEFINED.
+			 */
+			HashTable<int32_t, int32_t> * run(uint32_t source) {
+				// hash table for previous vertex
+				HashTable<int32_t, int32_t> *  previous = new HashTable<int32_t, int32_t>(g.vertex_count()); 
+				CSRGraph csr(g);
+				SPFA sp(csr);
+				uint32_t s = csr.index_of(source);
+
+				has_neg_cycle = s != CSRGraph::NONE && !sp.run(s);
+				for (uint32_t v = 0; v < csr.vertex_count(); v++) {
+					uint32_t p = s == CSRGraph::NONE ? BF_NONE : sp.prev(v);
+					(*previous)[csr.id(v)] = p == BF_NONE ? UNDEFINED : (int32_t)csr.id(p);
+				}
+
+				// a negative cycle elsewhere counts as well
+				if (!has_neg_cycle) has_neg_cycle = !sp.run_all();
 				return previous;	
 			}
 
+			/**
+			 * whether the graph contains a negative-weight cycle
+			 */
 			inline bool has_negative_cycle() { return has_neg_cycle; }
 	};
 }
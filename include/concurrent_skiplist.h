@@ -0,0 +1,401 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * LOCK-FREE CONCURRENT SKIP LIST
+ *
+ * Features:
+ * 1. lock-free insert/erase/lookup with CAS, safe for many concurrent writers
+ * 2. logical deletion by marking the low bit of the forward pointers,
+ *    physical unlinking is done by whoever walks over a marked node
+ * 3. the max level grows with the list (up to 32 levels, ~4G elements)
+ * 4. thread-local xorshift generator for level selection (no rand() lock)
+ * 5. forward iterators, lower_bound() for range scans
+ *
+ * Erased nodes are unlinked but only freed when the list is destroyed, so
+ * readers never touch freed memory. This is the usual memtable trade-off:
+ * the list lives for one flush cycle and is then dropped as a whole.
+ *
+ * http://en.wikipedia.org/wiki/Skip_list
+ * Herlihy & Shavit, The Art of Multiprocessor Programming, ch.14
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_CONCURRENT_SKIP_LIST_H__
+#define ALGO_CONCURRENT_SKIP_LIST_H__
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include <new>
+#include <exception>
+
+namespace alg {
+	template<typename KeyT, typename ValueT>
+	class ConcurrentSkipList {
+	private:
+		static const int SL_MAX_LEVEL = 32;
+
+		struct SkipNode {
+			KeyT	key;							// key
+			ValueT	value;							// value, immutable once linked
+			int		level;							// top level of this node
+			SkipNode * retired_next;				// link in the retired list
+			std::atomic<uintptr_t> * forward;		// marked pointers to different levels
+		};
+
+		SkipNode * m_header;						// the header node, empty
+		std::atomic<int> m_level;					// current max level of skip list
+		std::atomic<size_t> m_size;					// number of live keys
+		std::atomic<SkipNode *> m_retired;			// erased nodes, freed on destruction
+
+		class NotFoundException: public std::exception {
+			public:
+			virtual const char * what() const throw() {
+				return "cannot find the element in skiplist";
+			}
+		} excp_notfound;
+
+	public:
+		/**
+		 * weakly consistent forward iterator over level-0,
+		 * logically deleted nodes are skipped.
+		 */
+		class iterator {
+		private:
+			SkipNode * m_node;
+			friend class ConcurrentSkipList;
+			explicit iterator(SkipNode * n) : m_node(n) { skip_deleted(); }
+
+			void skip_deleted() {
+				while (m_node != NULL && is_marked(m_node->forward[0].load())) {
+					m_node = unmark(m_node->forward[0].load());
+				}
+			}
+		public:
+			iterator() : m_node(NULL) {}
+			const KeyT & key() const { return m_node->key; }
+			const ValueT & value() const { return m_node->value; }
+
+			iterator & operator++() {
+				m_node = unmark(m_node->forward[0].load());
+				skip_deleted();
+				return *this;
+			}
+
+			iterator operator++(int) {
+				iterator tmp(*this);
+				++(*this);
+				return tmp;
+			}
+
+			bool operator==(const iterator & rhs) const { return m_node == rhs.m_node; }
+			bool operator!=(const iterator & rhs) const { return m_node != rhs.m_node; }
+		};
+
+	public:
+		ConcurrentSkipList() : m_level(0), m_size(0), m_retired(NULL) {
+			m_header = make_node(SL_MAX_LEVEL - 1, KeyT(), ValueT());
+		}
+
+		/**
+		 * must not run concurrently with any other operation.
+		 */
+		~ConcurrentSkipList() {
+			// live nodes, and nodes marked but still linked at level-0
+			// belong to the retired list, skip them here.
+			SkipNode * x = unmark(m_header->forward[0].load());
+			while (x != NULL) {
+				uintptr_t next = x->forward[0].load();
+				if (!is_marked(next)) free_node(x);
+				x = unmark(next);
+			}
+
+			x = m_retired.load();
+			while (x != NULL) {
+				SkipNode * next = x->retired_next;
+				free_node(x);
+				x = next;
+			}
+			free_node(m_header);
+		}
+
+	private:
+		ConcurrentSkipList(const ConcurrentSkipList &);
+		ConcurrentSkipList& operator=(const ConcurrentSkipList &);
+
+	public:
+		/**
+		 * search the given key from the skip list
+		 * if the key is not exist, throw exception
+		 */
+		ValueT operator[] (const KeyT & key) const {
+			SkipNode * x = find_node(key);
+			if (x == NULL) throw excp_notfound;
+			return x->value;
+		}
+
+		/**
+		 * test whether the key exists.
+		 */
+		bool contains(const KeyT & key) const {
+			return find_node(key) != NULL;
+		}
+
+		/**
+		 * insert a key->value pair into the list
+		 * returns false if the key already exists.
+		 */
+		bool insert(const KeyT & key, const ValueT & value) {
+			SkipNode * preds[SL_MAX_LEVEL];
+			SkipNode * succs[SL_MAX_LEVEL];
+			SkipNode * x = NULL;
+			int lvl = random_level();
+
+			while (true) {
+				if (find(key, preds, succs)) {
+					if (x != NULL) free_node(x);
+					return false;
+				}
+
+				if (x == NULL) x = make_node(lvl, key, value);
+				for (int i = 0; i <= lvl; i++) {
+					x->forward[i].store((uintptr_t)succs[i], std::memory_order_relaxed);
+				}
+
+				// the node is in the list once it's linked at level-0
+				uintptr_t expected = (uintptr_t)succs[0];
+				if (preds[0]->forward[0].compare_exchange_strong(expected, (uintptr_t)x)) {
+					break;
+				}
+			}
+			m_size.fetch_add(1, std::memory_order_relaxed);
+
+			// link the upper levels, bottom-up
+			for (int i = 1; i <= lvl; i++) {
+				while (true) {
+					// refresh our forward pointer, stop if someone deleted us
+					uintptr_t cur = x->forward[i].load();
+					if (is_marked(cur)) return true;
+					if (unmark(cur) != succs[i] &&
+						!x->forward[i].compare_exchange_strong(cur, (uintptr_t)succs[i])) {
+						return true;
+					}
+
+					uintptr_t expected = (uintptr_t)succs[i];
+					if (preds[i]->forward[i].compare_exchange_strong(expected, (uintptr_t)x)) {
+						break;
+					}
+					find(key, preds, succs);
+					if (succs[0] != x) return true;		// erased meanwhile
+				}
+			}
+
+			// raise the list level
+			int cur_level = m_level.load();
+			while (lvl > cur_level && !m_level.compare_exchange_weak(cur_level, lvl)) {}
+			return true;
+		}
+
+		/**
+		 * delete a node by it's key
+		 * returns false if the key does not exist.
+		 */
+		bool delete_key(const KeyT & key) {
+			SkipNode * preds[SL_MAX_LEVEL];
+			SkipNode * succs[SL_MAX_LEVEL];
+
+			if (!find(key, preds, succs)) return false;
+			SkipNode * x = succs[0];
+
+			// mark the upper levels top-down
+			for (int i = x->level; i >= 1; i--) {
+				uintptr_t next = x->forward[i].load();
+				while (!is_marked(next)) {
+					x->forward[i].compare_exchange_weak(next, next | 1);
+				}
+			}
+
+			// whoever marks level-0 owns the deletion
+			uintptr_t next = x->forward[0].load();
+			while (true) {
+				if (is_marked(next)) return false;
+				if (x->forward[0].compare_exchange_weak(next, next | 1)) break;
+			}
+
+			m_size.fetch_sub(1, std::memory_order_relaxed);
+			find(key, preds, succs);	// physically unlink
+			retire(x);
+			return true;
+		}
+
+		/**
+		 * number of keys, approximate while writers are active.
+		 */
+		size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+		/**
+		 * the iterator to the smallest key
+		 */
+		iterator begin() const { return iterator(unmark(m_header->forward[0].load())); }
+		iterator end() const { return iterator(); }
+
+		/**
+		 * the iterator to the first key not less than `key`
+		 */
+		iterator lower_bound(const KeyT & key) const {
+			SkipNode * x = m_header;
+			for (int i = m_level.load(); i >= 0; i--) {
+				SkipNode * next = unmark(x->forward[i].load());
+				while (next != NULL && next->key < key) {
+					x = next;
+					next = unmark(x->forward[i].load());
+				}
+			}
+			return iterator(unmark(x->forward[0].load()));
+		}
+
+		void print() const {
+			for (iterator it = begin(); it != end(); ++it) {
+				printf("%d->%d ", (int)it.key(), (int)it.value());
+			}
+			printf("\n");
+		}
+
+	private:
+		static inline bool is_marked(uintptr_t p) { return p & 1; }
+		static inline SkipNode * unmark(uintptr_t p) { return (SkipNode *)(p & ~(uintptr_t)1); }
+
+		/**
+		 * wait-free lookup, does not help unlinking.
+		 */
+		SkipNode * find_node(const KeyT & key) const {
+			SkipNode * x = m_header;
+			SkipNode * next = NULL;
+			for (int i = m_level.load(); i >= 0; i--) {
+				next = unmark(x->forward[i].load());
+				while (next != NULL) {
+					uintptr_t succ = next->forward[i].load();
+					if (is_marked(succ)) {		// skip over deleted nodes
+						next = unmark(succ);
+					} else if (next->key < key) {
+						x = next;
+						next = unmark(succ);
+					} else {
+						break;
+					}
+				}
+			}
+			if (next != NULL && !(key < next->key) && !is_marked(next->forward[0].load()))
+				return next;
+			return NULL;
+		}
+
+		/**
+		 * locate the predecessors & successors of `key` on each level,
+		 * unlinking every marked node on the way.
+		 */
+		bool find(const KeyT & key, SkipNode ** preds, SkipNode ** succs) {
+		retry:
+			int top = m_level.load();
+			for (int i = SL_MAX_LEVEL - 1; i > top; i--) {
+				preds[i] = m_header;
+				succs[i] = unmark(m_header->forward[i].load());
+			}
+
+			SkipNode * pred = m_header;
+			for (int i = top; i >= 0; i--) {
+				SkipNode * curr = unmark(pred->forward[i].load());
+				while (curr != NULL) {
+					uintptr_t succ = curr->forward[i].load();
+					while (is_marked(succ)) {
+						uintptr_t expected = (uintptr_t)curr;
+						if (!pred->forward[i].compare_exchange_strong(expected, (uintptr_t)unmark(succ)))
+							goto retry;
+						curr = unmark(succ);
+						if (curr == NULL) break;
+						succ = curr->forward[i].load();
+					}
+					if (curr == NULL || !(curr->key < key)) break;
+					pred = curr;
+					curr = unmark(succ);
+				}
+				preds[i] = pred;
+				succs[i] = curr;
+			}
+			return succs[0] != NULL && !(key < succs[0]->key);
+		}
+
+		/**
+		 * push a deleted node onto the retired list
+		 */
+		void retire(SkipNode * x) {
+			SkipNode * head = m_retired.load();
+			do {
+				x->retired_next = head;
+			} while (!m_retired.compare_exchange_weak(head, x));
+		}
+
+		/**
+		 * xorshift64*, one state per thread
+		 */
+		static uint64_t thread_rand() {
+			static thread_local uint64_t state = 0;
+			if (state == 0) {
+				state = (uint64_t)(uintptr_t)&state ^ ((uint64_t)time(NULL) << 32) ^ 0x9E3779B97F4A7C15ULL;
+			}
+			state ^= state >> 12;
+			state ^= state << 25;
+			state ^= state >> 27;
+			return state * 2685821657736338717ULL;
+		}
+
+		/**
+		 * get the random promote level,
+		 * the possibility is 1/2 for each level, and a node is at most
+		 * one level higher than the current list.
+		 */
+		int random_level() const {
+			uint64_t r = thread_rand();
+			int limit = m_level.load() + 1;
+			if (limit > SL_MAX_LEVEL - 1) limit = SL_MAX_LEVEL - 1;
+
+			int lvl = 0;
+			while ((r & 1) && lvl < limit) {
+				lvl++;
+				r >>= 1;
+			}
+			return lvl;
+		}
+
+		/**
+		 * make a node with specified level & key
+		 */
+		SkipNode * make_node(int level, const KeyT & key, const ValueT & value) {
+			SkipNode * n = new SkipNode;
+
+			// the max forward entry for a key is : level + 1
+			n->forward = new std::atomic<uintptr_t>[level + 1];
+			for (int i = 0; i <= level; i++) {
+				n->forward[i].store(0, std::memory_order_relaxed);
+			}
+			n->key = key;
+			n->value = value;
+			n->level = level;
+			n->retired_next = NULL;
+
+			return n;
+		}
+
+		static void free_node(SkipNode * n) {
+			delete [] n->forward;
+			delete n;
+		}
+	};
+}
+
+#endif //
@@ -0,0 +1,523 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * CONTRACTION HIERARCHIES
+ *
+ * Features:
+ * 1. preprocessing: the vertices are contracted one by one, the least
+ *    important first. contracting v adds a shortcut u->w for every path
+ *    u->v->w that is the only shortest one, found by a bounded "witness"
+ *    Dijkstra from u avoiding v. the order comes from a lazily updated
+ *    priority: edge difference + contracted neighbours + level.
+ * 2. the index keeps, for every vertex, only the edges towards more
+ *    important vertices, both ways, in adjacency arrays numbered by rank
+ *    (the top of the hierarchy, visited by every query, is contiguous).
+ *    a shortcut remembers the vertex it bypasses, to unpack paths.
+ * 3. save / load the index as flat binary arrays (native byte order).
+ * 4. CHQuery: bidirectional Dijkstra, both searches only go up the
+ *    hierarchy, with stall-on-demand. a query settles a few hundred
+ *    vertices instead of the whole graph. one CHQuery per thread.
+ *
+ * Directed graphs with non-negative weights, vertices are the dense
+ * indices of a CSRGraph.
+ *
+ * http://en.wikipedia.org/wiki/Contraction_hierarchies
+ * Geisberger, Sanders, Schultes & Delling, Contraction Hierarchies: Faster
+ * and Simpler Hierarchical Routing in Road Networks, 2008
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_CONTRACTION_HIERARCHY_H__
+#define ALGO_CONTRACTION_HIERARCHY_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "heap.h"
+#include "csr_graph.h"
+
+namespace alg {
+	static const uint32_t CH_NONE = UINT32_MAX;
+	static const int64_t CH_INF = INT64_MAX;
+
+	namespace detail {
+		/**
+		 * the graph being contracted
+		 */
+		class CHBuilder {
+			public:
+				struct Arc {
+					uint32_t to;
+					int32_t weight;
+					uint32_t mid;		// the bypassed vertex, CH_NONE for an edge
+				};
+				struct Shortcut {
+					uint32_t u, w;
+					int32_t weight;
+				};
+				static const uint32_t WITNESS_LIMIT = 500;	// vertices settled by a witness search
+
+				uint32_t n;
+				std::vector<std::vector<Arc> > out, in;
+				std::vector<uint32_t> deleted;		// contracted neighbours
+				std::vector<uint32_t> level;
+
+			private:
+				std::vector<int64_t> m_dist;
+				std::vector<uint32_t> m_touched;
+				IndexedHeap<int64_t> m_heap;
+				std::vector<Shortcut> m_tmp;		// the shortcuts of m_tmp_v, by priority()
+				uint32_t m_tmp_v;
+				std::vector<uint8_t> m_target;		// out-neighbours of the vertex contracted
+
+			public:
+				explicit CHBuilder(const CSRGraph & g) : n(g.vertex_count()), out(n), in(n),
+					deleted(n, 0), level(n, 0), m_dist(n, CH_INF), m_heap(n), m_tmp_v(CH_NONE), m_target(n, 0) {
+					for (uint32_t u = 0; u < n; u++) {
+						for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+							if (g.weight(e) < 0) throw std::invalid_argument("negative weight");
+							if (g.target(e) != u) add_arc(u, g.target(e), g.weight(e), CH_NONE);
+						}
+					}
+				}
+
+				/**
+				 * u->w, only the lighter one is kept between the same pair
+				 */
+				void add_arc(uint32_t u, uint32_t w, int32_t weight, uint32_t mid) {
+					for (size_t k = 0; k < out[u].size(); k++) {
+						if (out[u][k].to != w) continue;
+						if (weight < out[u][k].weight) {
+							out[u][k].weight = weight;
+							out[u][k].mid = mid;
+							for (size_t j = 0; j < in[w].size(); j++) {
+								if (in[w][j].to == u) {
+									in[w][j].weight = weight;
+									in[w][j].mid = mid;
+								}
+							}
+						}
+						return;
+					}
+					Arc a = {w, weight, mid};
+					out[u].push_back(a);
+					a.to = u;
+					in[w].push_back(a);
+				}
+
+				/**
+				 * the shortcuts contracting v would need, a witness search
+				 * settles at most WITNESS_LIMIT vertices.
+				 */
+				void shortcuts(uint32_t v, std::vector<Shortcut> & sc) {
+					sc.clear();
+					for (size_t k = 0; k < out[v].size(); k++) m_target[out[v][k].to] = 1;
+					for (size_t i = 0; i < in[v].size(); i++) {
+						uint32_t u = in[v][i].to;
+						int64_t maxd = -1;
+						uint32_t targets = 0;
+						for (size_t k = 0; k < out[v].size(); k++) {
+							if (out[v][k].to == u) continue;
+							maxd = std::max(maxd, (int64_t)in[v][i].weight + out[v][k].weight);
+							targets++;
+						}
+						if (targets == 0) continue;
+
+						witness(u, v, maxd, targets);
+						for (size_t k = 0; k < out[v].size(); k++) {
+							uint32_t w = out[v][k].to;
+							if (w == u) continue;
+							int64_t via = (int64_t)in[v][i].weight + out[v][k].weight;
+							if (m_dist[w] <= via) continue;
+							if (via > INT32_MAX) throw std::overflow_error("shortcut weight");
+							Shortcut s = {u, w, (int32_t)via};
+							sc.push_back(s);
+						}
+						reset();
+					}
+					for (size_t k = 0; k < out[v].size(); k++) m_target[out[v][k].to] = 0;
+				}
+
+				int64_t priority(uint32_t v) {
+					shortcuts(v, m_tmp);
+					m_tmp_v = v;
+					int64_t diff = (int64_t)m_tmp.size() - (int64_t)in[v].size() - (int64_t)out[v].size();
+					return 2 * diff + deleted[v] + level[v];
+				}
+
+				/**
+				 * contract v: add its shortcuts, and take it out of the lists
+				 * of its neighbours. what is left in out[v] & in[v] are the
+				 * edges to more important vertices.
+				 */
+				void contract(uint32_t v) {
+					if (m_tmp_v != v) shortcuts(v, m_tmp);
+					m_tmp_v = CH_NONE;
+					for (size_t i = 0; i < m_tmp.size(); i++) add_arc(m_tmp[i].u, m_tmp[i].w, m_tmp[i].weight, v);
+					for (size_t i = 0; i < in[v].size(); i++) {
+						uint32_t u = in[v][i].to;
+						unlink(out[u], v);
+						deleted[u]++;
+						level[u] = std::max(level[u], level[v] + 1);
+					}
+					for (size_t i = 0; i < out[v].size(); i++) {
+						uint32_t w = out[v][i].to;
+						unlink(in[w], v);
+						deleted[w]++;
+						level[w] = std::max(level[w], level[v] + 1);
+					}
+				}
+
+			private:
+				static void unlink(std::vector<Arc> & list, uint32_t v) {
+					for (size_t k = 0; k < list.size(); k++) {
+						if (list[k].to == v) {
+							list[k] = list.back();
+							list.pop_back();
+							return;
+						}
+					}
+				}
+
+				/**
+				 * Dijkstra from u in the remaining graph without v, up to
+				 * distance maxd or until the targets are settled
+				 */
+				void witness(uint32_t u, uint32_t v, int64_t maxd, uint32_t targets) {
+					m_dist[u] = 0;
+					m_touched.push_back(u);
+					m_heap.push(u, 0);
+					uint32_t settled = 0;
+					while (!m_heap.is_empty()) {
+						uint32_t x = m_heap.pop();
+						if (m_dist[x] > maxd || ++settled > WITNESS_LIMIT) break;
+						if (m_target[x] && x != u && --targets == 0) break;
+						for (size_t k = 0; k < out[x].size(); k++) {
+							uint32_t y = out[x][k].to;
+							if (y == v) continue;
+							int64_t d = m_dist[x] + out[x][k].weight;
+							if (d < m_dist[y]) {
+								if (m_dist[y] == CH_INF) m_touched.push_back(y);
+								m_dist[y] = d;
+								m_heap.push(y, d);
+							}
+						}
+					}
+				}
+
+				void reset() {
+					for (size_t i = 0; i < m_touched.size(); i++) m_dist[m_touched[i]] = CH_INF;
+					m_touched.clear();
+					m_heap.clear();
+				}
+		};
+	}
+
+	class ContractionHierarchy {
+		public:
+			struct Arc {
+				uint32_t to;
+				int32_t weight;
+			};
+
+		private:
+			static const uint32_t MAGIC = 0x58494843;	// "CHIX"
+
+			uint32_t m_n;
+			std::vector<uint32_t> m_rank;		// vertex -> rank
+			std::vector<uint32_t> m_order;		// rank -> vertex
+			// by rank: the arcs up to more important vertices, & the arcs
+			// coming down from them
+			std::vector<uint32_t> m_up_offset, m_down_offset;
+			std::vector<Arc> m_up, m_down;
+			std::vector<uint32_t> m_up_mid, m_down_mid;		// rank of the bypassed vertex, or CH_NONE
+
+		public:
+			ContractionHierarchy() : m_n(0), m_up_offset(1, 0), m_down_offset(1, 0) {}
+
+			/**
+			 * preprocess a graph, O(E) memory for the index
+			 */
+			explicit ContractionHierarchy(const CSRGraph & g) {
+				detail::CHBuilder b(g);
+				uint32_t n = b.n;
+				m_n = n;
+				m_rank.assign(n, CH_NONE);
+				m_order.clear();
+				m_order.reserve(n);
+
+				IndexedHeap<int64_t> pq(n);
+				for (uint32_t v = 0; v < n; v++) pq.push(v, b.priority(v));
+				while (!pq.is_empty()) {
+					uint32_t v = pq.pop();
+					// lazy update: the priority is stale once a neighbour is
+					// contracted, v goes back if it is no longer the smallest.
+					// the shortcuts found are kept for contract().
+					int64_t p = b.priority(v);
+					if (!pq.is_empty() && p > pq.key(pq.top())) {
+						pq.push(v, p);
+						continue;
+					}
+
+					b.contract(v);
+					m_rank[v] = (uint32_t)m_order.size();
+					m_order.push_back(v);
+				}
+
+				flatten(b.out, m_up_offset, m_up, m_up_mid);
+				flatten(b.in, m_down_offset, m_down, m_down_mid);
+			}
+
+			inline uint32_t vertex_count() const { return m_n; }
+			/**
+			 * number of arcs in the index, edges & shortcuts
+			 */
+			uint32_t arc_count() const { return (uint32_t)(m_up.size() + m_down.size()); }
+			inline uint32_t rank(uint32_t v) const { return m_rank[v]; }
+
+			/**
+			 * write the index, returns false on an I/O error
+			 */
+			bool save(FILE * fp) const {
+				uint32_t hdr[4] = {MAGIC, m_n, (uint32_t)m_up.size(), (uint32_t)m_down.size()};
+				return fwrite(hdr, sizeof(hdr), 1, fp) == 1 &&
+					write(fp, m_order) && write(fp, m_up_offset) && write(fp, m_up) && write(fp, m_up_mid) &&
+					write(fp, m_down_offset) && write(fp, m_down) && write(fp, m_down_mid);
+			}
+
+			/**
+			 * read an index written by save(), returns false if the file is
+			 * short or not a valid index.
+			 */
+			bool load(FILE * fp) {
+				uint32_t hdr[4];
+				if (fread(hdr, sizeof(hdr), 1, fp) != 1 || hdr[0] != MAGIC) return false;
+				uint32_t n = hdr[1];
+				m_n = n;
+				bool ok = read(fp, m_order, n) &&
+					read(fp, m_up_offset, (size_t)n + 1) && read(fp, m_up, hdr[2]) && read(fp, m_up_mid, hdr[2]) &&
+					read(fp, m_down_offset, (size_t)n + 1) && read(fp, m_down, hdr[3]) && read(fp, m_down_mid, hdr[3]);
+				if (!ok) {
+					*this = ContractionHierarchy();
+					return false;
+				}
+
+				m_rank.assign(n, CH_NONE);
+				for (uint32_t r = 0; ok && r < n; r++) {
+					if (m_order[r] >= n || m_rank[m_order[r]] != CH_NONE) ok = false;
+					else m_rank[m_order[r]] = r;
+				}
+				ok = ok && valid(m_up_offset, m_up, m_up_mid) && valid(m_down_offset, m_down, m_down_mid);
+				if (!ok) *this = ContractionHierarchy();
+				return ok;
+			}
+
+			friend class CHQuery;
+
+		private:
+			void flatten(const std::vector<std::vector<detail::CHBuilder::Arc> > & lists,
+					std::vector<uint32_t> & offset, std::vector<Arc> & arcs, std::vector<uint32_t> & mid) {
+				offset.assign(m_n + 1, 0);
+				for (uint32_t r = 0; r < m_n; r++) offset[r + 1] = offset[r] + (uint32_t)lists[m_order[r]].size();
+				arcs.resize(offset[m_n]);
+				mid.resize(offset[m_n]);
+				for (uint32_t r = 0; r < m_n; r++) {
+					const std::vector<detail::CHBuilder::Arc> & l = lists[m_order[r]];
+					for (size_t k = 0; k < l.size(); k++) {
+						Arc a = {m_rank[l[k].to], l[k].weight};
+						arcs[offset[r] + k] = a;
+						mid[offset[r] + k] = l[k].mid == CH_NONE ? CH_NONE : m_rank[l[k].mid];
+					}
+				}
+			}
+
+			/**
+			 * the arcs of rank r go up, a shortcut bypasses a lower vertex
+			 */
+			bool valid(const std::vector<uint32_t> & offset, const std::vector<Arc> & arcs,
+					const std::vector<uint32_t> & mid) const {
+				if (offset[0] != 0 || offset[m_n] != arcs.size()) return false;
+				for (uint32_t r = 0; r < m_n; r++) {
+					if (offset[r] > offset[r + 1]) return false;
+					for (uint32_t k = offset[r]; k < offset[r + 1]; k++) {
+						if (arcs[k].to >= m_n || arcs[k].to <= r || arcs[k].weight < 0) return false;
+						if (mid[k] != CH_NONE && mid[k] >= r) return false;
+					}
+				}
+				return true;
+			}
+
+			template<typename T>
+			static bool write(FILE * fp, const std::vector<T> & v) {
+				return v.empty() || fwrite(&v[0], sizeof(T), v.size(), fp) == v.size();
+			}
+
+			/**
+			 * a chunk at a time, a corrupt count can't allocate more than
+			 * the file holds
+			 */
+			template<typename T>
+			static bool read(FILE * fp, std::vector<T> & v, size_t count) {
+				const size_t CHUNK = 1 << 16;
+				v.clear();
+				while (v.size() < count) {
+					size_t at = v.size(), k = std::min(CHUNK, count - at);
+					v.resize(at + k);
+					if (fread(&v[at], sizeof(T), k, fp) != k) return false;
+				}
+				return true;
+			}
+
+			/**
+			 * the mid of the arc a->b, in whichever list holds it
+			 */
+			uint32_t mid_of(uint32_t a, uint32_t b) const {
+				if (a < b) {
+					for (uint32_t k = m_up_offset[a]; k < m_up_offset[a + 1]; k++) {
+						if (m_up[k].to == b) return m_up_mid[k];
+					}
+				} else {
+					for (uint32_t k = m_down_offset[b]; k < m_down_offset[b + 1]; k++) {
+						if (m_down[k].to == a) return m_down_mid[k];
+					}
+				}
+				return CH_NONE;
+			}
+	};
+
+	/**
+	 * point to point queries on a ContractionHierarchy
+	 */
+	class CHQuery {
+		private:
+			const ContractionHierarchy & ch;
+			// [0] the forward search from s, [1] the backward search from t
+			std::vector<int64_t> m_dist[2];
+			std::vector<uint32_t> m_parent[2];
+			std::vector<uint32_t> m_touched[2];
+			std::vector<IndexedHeap<int64_t> > m_heap;
+			uint32_t m_meet;
+			uint32_t m_settled;
+
+		public:
+			explicit CHQuery(const ContractionHierarchy & index) : ch(index),
+				m_heap(2, IndexedHeap<int64_t>(index.m_n)), m_meet(CH_NONE), m_settled(0) {
+				for (int d = 0; d < 2; d++) {
+					m_dist[d].assign(index.m_n, CH_INF);
+					m_parent[d].assign(index.m_n, CH_NONE);
+				}
+			}
+
+			/**
+			 * the distance from s to t, CH_INF if t is unreachable
+			 */
+			int64_t distance(uint32_t s, uint32_t t) {
+				for (int d = 0; d < 2; d++) {
+					for (size_t i = 0; i < m_touched[d].size(); i++) m_dist[d][m_touched[d][i]] = CH_INF;
+					m_touched[d].clear();
+					m_heap[d].clear();
+				}
+				m_settled = 0;
+				uint32_t rs = ch.m_rank[s], rt = ch.m_rank[t];
+				label(0, rs, 0, CH_NONE);
+				label(1, rt, 0, CH_NONE);
+
+				int64_t best = CH_INF;
+				m_meet = CH_NONE;
+				while (!m_heap[0].is_empty() || !m_heap[1].is_empty()) {
+					for (int d = 0; d < 2; d++) {
+						IndexedHeap<int64_t> & Q = m_heap[d];
+						if (Q.is_empty()) continue;
+						if (Q.key(Q.top()) >= best) {
+							Q.clear();
+							continue;
+						}
+						uint32_t u = Q.pop();
+						m_settled++;
+						int64_t du = m_dist[d][u];
+						if (m_dist[1 - d][u] != CH_INF && du + m_dist[1 - d][u] < best) {
+							best = du + m_dist[1 - d][u];
+							m_meet = u;
+						}
+						if (stalled(d, u)) continue;
+
+						const std::vector<ContractionHierarchy::Arc> & arcs = d == 0 ? ch.m_up : ch.m_down;
+						const std::vector<uint32_t> & offset = d == 0 ? ch.m_up_offset : ch.m_down_offset;
+						for (uint32_t k = offset[u]; k < offset[u + 1]; k++) {
+							uint32_t v = arcs[k].to;
+							int64_t dv = du + arcs[k].weight;
+							if (dv < m_dist[d][v]) label(d, v, dv, u);
+						}
+					}
+				}
+				return best;
+			}
+
+			/**
+			 * the shortest path s ... t, false if there is none
+			 */
+			bool path(uint32_t s, uint32_t t, std::vector<uint32_t> & p) {
+				p.clear();
+				if (distance(s, t) == CH_INF) return false;
+
+				// up from s to the meeting vertex, then down to t, in ranks
+				std::vector<uint32_t> ranks;
+				for (uint32_t v = m_meet; v != CH_NONE; v = m_parent[0][v]) ranks.push_back(v);
+				std::reverse(ranks.begin(), ranks.end());
+				for (uint32_t v = m_parent[1][m_meet]; v != CH_NONE; v = m_parent[1][v]) ranks.push_back(v);
+
+				p.push_back(ch.m_order[ranks[0]]);
+				std::vector<std::pair<uint32_t, uint32_t> > stack;
+				for (size_t i = 0; i + 1 < ranks.size(); i++) {
+					stack.push_back(std::make_pair(ranks[i], ranks[i + 1]));
+					while (!stack.empty()) {
+						uint32_t a = stack.back().first, b = stack.back().second;
+						stack.pop_back();
+						uint32_t m = ch.mid_of(a, b);
+						if (m == CH_NONE) {
+							p.push_back(ch.m_order[b]);
+						} else {
+							stack.push_back(std::make_pair(m, b));
+							stack.push_back(std::make_pair(a, m));
+						}
+					}
+				}
+				return true;
+			}
+
+			/**
+			 * vertices settled by the last query
+			 */
+			inline uint32_t settled() const { return m_settled; }
+
+		private:
+			inline void label(int d, uint32_t v, int64_t dist, uint32_t parent) {
+				if (m_dist[d][v] == CH_INF) m_touched[d].push_back(v);
+				m_dist[d][v] = dist;
+				m_parent[d][v] = parent;
+				m_heap[d].push(v, dist);
+			}
+
+			/**
+			 * stall-on-demand: a more important vertex already reaches u
+			 * by a shorter way, u is not on a shortest up-down path.
+			 */
+			bool stalled(int d, uint32_t u) const {
+				const std::vector<ContractionHierarchy::Arc> & arcs = d == 0 ? ch.m_down : ch.m_up;
+				const std::vector<uint32_t> & offset = d == 0 ? ch.m_down_offset : ch.m_up_offset;
+				for (uint32_t k = offset[u]; k < offset[u + 1]; k++) {
+					int64_t dx = m_dist[d][arcs[k].to];
+					if (dx != CH_INF && dx + arcs[k].weight < m_dist[d][u]) return true;
+				}
+				return false;
+			}
+	};
+}
+
+#endif //
@@ -0,0 +1,595 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * COMPRESSED SPARSE ROW (CSR) GRAPH
+ *
+ * Features:
+ * 1. a read-only snapshot of a Graph in three flat arrays, vertices are
+ *    renumbered to dense indices 0..n-1
+ * 2. the out-edges of u are the slots [offset(u), offset(u+1)) of the
+ *    target & weight arrays, a scan is a sequential read
+ * 3. built from a Graph, or from an edge array in O(V + E)
+ * 4. a binary file of the same arrays (save / load), that map() uses in
+ *    place through mmap: no parsing, the pages are read on demand & shared
+ *    between the processes. the weights are optional (all 1 without), and
+ *    so are the vertex ids when they are 0..n-1.
+ * 5. load_edge_list: text "u v [weight]" lines, any uint32 vertex ids.
+ * 6. permute: the same graph under another numbering, see graph_reorder.h
+ *    for numberings that put the neighbours close together.
+ *
+ * The list based Graph is fine to edit, while the array algorithms
+ * (MST, SCC, flows, shortest paths ...) run on this representation.
+ *
+ * File layout, native byte order, every array starts 8-byte aligned:
+ *   magic "CSRG", version, flags (1 weighted, 2 ids), n, m (uint64)
+ *   offset[n+1], target[m], weight[m] if weighted, id[n] if ids
+ *
+ * http://en.wikipedia.org/wiki/Sparse_matrix#Compressed_sparse_row_.28CSR.2C_CRS_or_Yale_format.29
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_CSR_GRAPH_H__
+#define ALGO_CSR_GRAPH_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ALGO_CSR_MMAP 1
+#endif
+#include "graph_defs.h"
+#include "double_linked_list.h"
+#include "radix_sort.h"
+
+namespace alg {
+	/**
+	 * a weighted edge u->v (or u<->v), u & v are dense vertex indices 0..n-1
+	 */
+	struct WeightedEdge {
+		uint32_t u;
+		uint32_t v;
+		int32_t weight;
+	};
+
+	class CSRGraph {
+		public:
+			static const uint32_t NONE = UINT32_MAX;
+
+		private:
+			enum {
+				MAGIC = 0x47525343,		// "CSRG"
+				VERSION = 1,
+				F_WEIGHTED = 1,
+				F_IDS = 2
+			};
+
+			uint32_t m_n;
+			// the arrays, in the vectors below or in a mapped file
+			const uint32_t * m_off;				// out-edges of u: [m_off[u], m_off[u+1])
+			const uint32_t * m_tgt;
+			int32_t * m_w;						// NULL: every weight is 1
+			const uint32_t * m_id;				// dense index -> vertex id, ascending; NULL: the index
+
+			std::vector<uint32_t> m_offset;
+			std::vector<uint32_t> m_target;
+			std::vector<int32_t> m_weight;
+			std::vector<uint32_t> m_ids;
+			void * m_map;
+			size_t m_map_size;
+
+		public:
+			CSRGraph() : m_n(0), m_offset(1, 0), m_map(NULL), m_map_size(0) { attach(); }
+
+			/**
+			 * snapshot a Graph, the vertices are numbered by ascending id.
+			 */
+			explicit CSRGraph(const Graph & g) : m_n(g.vertex_count()), m_offset(g.vertex_count() + 1, 0),
+				m_map(NULL), m_map_size(0) {
+				Graph::Adjacent * a;
+				m_ids.reserve(m_n);
+				list_for_each_entry(a, &g.list(), a_node){
+					m_ids.push_back(a->v.id);
+				}
+				std::sort(m_ids.begin(), m_ids.end());
+				attach();
+
+				list_for_each_entry(a, &g.list(), a_node){
+					m_offset[index_of(a->v.id) + 1] = a->num_neigh;
+				}
+				for (uint32_t u = 0; u < m_n; u++) m_offset[u + 1] += m_offset[u];
+
+				m_target.resize(m_offset[m_n]);
+				m_weight.resize(m_offset[m_n]);
+				list_for_each_entry(a, &g.list(), a_node){
+					uint32_t e = m_offset[index_of(a->v.id)];
+					Graph::Vertex * v;
+					list_for_each_entry(v, &a->v_head, v_node){
+						m_target[e] = index_of(v->id);
+						m_weight[e] = v->weight;
+						e++;
+					}
+				}
+				attach();
+			}
+
+			/**
+			 * build from `m` edges over the vertices 0..n-1, the vertex ids
+			 * are the indices. an undirected graph stores each edge both ways.
+			 */
+			CSRGraph(uint32_t n, const WeightedEdge edges[], uint32_t m, bool undirected = false) :
+				m_n(n), m_map(NULL), m_map_size(0) {
+				build(n, edges, m, undirected);
+			}
+
+			/**
+			 * a copy owns its arrays, even of a mapped graph
+			 */
+			CSRGraph(const CSRGraph & o) : m_map(NULL), m_map_size(0) { copy(o); }
+
+			CSRGraph & operator=(const CSRGraph & o) {
+				if (this != &o) {
+					unmap();
+					copy(o);
+				}
+				return *this;
+			}
+
+			~CSRGraph() { unmap(); }
+
+			/**
+			 * the graph with every edge reversed, same vertex numbering
+			 */
+			CSRGraph transpose() const {
+				CSRGraph t;
+				t.m_n = m_n;
+				if (m_id) t.m_ids.assign(m_id, m_id + m_n);
+				t.m_offset.assign(m_n + 1, 0);
+				uint32_t m = edge_count();
+				for (uint32_t e = 0; e < m; e++) t.m_offset[m_tgt[e] + 1]++;
+				for (uint32_t u = 0; u < m_n; u++) t.m_offset[u + 1] += t.m_offset[u];
+
+				t.m_target.resize(m);
+				if (m_w) t.m_weight.resize(m);
+				std::vector<uint32_t> pos(t.m_offset.begin(), t.m_offset.end() - 1);
+				for (uint32_t u = 0; u < m_n; u++) {
+					for (uint32_t e = m_off[u]; e < m_off[u + 1]; e++) {
+						uint32_t f = pos[m_tgt[e]]++;
+						t.m_target[f] = u;
+						if (m_w) t.m_weight[f] = m_w[e];
+					}
+				}
+				t.attach();
+				return t;
+			}
+
+			/**
+			 * the graph renumbered by perm (old index -> new index), a
+			 * permutation of 0..n-1: u->v becomes perm[u]->perm[v], the
+			 * out-edges of a vertex by ascending target. the vertex ids of
+			 * the result are the new indices, perm maps back.
+			 */
+			CSRGraph permute(const std::vector<uint32_t> & perm) const {
+				if (perm.size() != m_n) throw std::invalid_argument("permutation size");
+				std::vector<uint32_t> inv(m_n, (uint32_t)NONE);
+				for (uint32_t u = 0; u < m_n; u++) {
+					if (perm[u] >= m_n || inv[perm[u]] != (uint32_t)NONE) throw std::invalid_argument("not a permutation");
+					inv[perm[u]] = u;
+				}
+
+				CSRGraph t;
+				t.m_n = m_n;
+				t.m_offset.assign(m_n + 1, 0);
+				for (uint32_t i = 0; i < m_n; i++) t.m_offset[i + 1] = t.m_offset[i] + degree(inv[i]);
+				t.m_target.resize(edge_count());
+				if (m_w) t.m_weight.resize(edge_count());
+				std::vector<std::pair<uint32_t, int32_t> > row;
+				for (uint32_t i = 0; i < m_n; i++) {
+					uint32_t u = inv[i], f = t.m_offset[i];
+					row.clear();
+					for (uint32_t e = m_off[u]; e < m_off[u + 1]; e++) {
+						row.push_back(std::make_pair(perm[m_tgt[e]], m_w ? m_w[e] : 1));
+					}
+					std::sort(row.begin(), row.end());
+					for (size_t k = 0; k < row.size(); k++, f++) {
+						t.m_target[f] = row[k].first;
+						if (m_w) t.m_weight[f] = row[k].second;
+					}
+				}
+				t.attach();
+				return t;
+			}
+
+			uint32_t vertex_count() const { return m_n; }
+			/**
+			 * number of stored (directed) edges
+			 */
+			uint32_t edge_count() const { return m_off[m_n]; }
+			/**
+			 * false when every weight is 1, weights() is then NULL
+			 */
+			bool weighted() const { return m_w != NULL; }
+
+			inline uint32_t begin(uint32_t u) const { return m_off[u]; }
+			inline uint32_t end(uint32_t u) const { return m_off[u + 1]; }
+			inline uint32_t degree(uint32_t u) const { return m_off[u + 1] - m_off[u]; }
+			inline uint32_t target(uint32_t e) const { return m_tgt[e]; }
+			inline int32_t weight(uint32_t e) const { return m_w ? m_w[e] : 1; }
+
+			/**
+			 * change the weight of an edge in place, the structure is fixed.
+			 * a mapped file is not written, the pages are copied on write.
+			 */
+			void set_weight(uint32_t e, int32_t w) {
+				if (!m_w) {
+					m_weight.assign(edge_count(), 1);
+					m_w = &m_weight[0];
+				}
+				m_w[e] = w;
+			}
+
+			/**
+			 * the tail of edge e, by a binary search, O(logV)
+			 */
+			uint32_t source(uint32_t e) const {
+				return (uint32_t)(std::upper_bound(m_off, m_off + m_n + 1, e) - m_off) - 1;
+			}
+
+			/**
+			 * the raw arrays, for the inner loops
+			 */
+			const uint32_t * offsets() const { return m_off; }
+			const uint32_t * targets() const { return m_tgt; }
+			const int32_t * weights() const { return m_w; }
+
+			/**
+			 * the vertex id of a dense index, and back.
+			 * index_of returns NONE for an unknown id.
+			 */
+			inline uint32_t id(uint32_t u) const { return m_id ? m_id[u] : u; }
+			uint32_t index_of(uint32_t id) const {
+				if (!m_id) return id < m_n ? id : NONE;
+				const uint32_t * it = std::lower_bound(m_id, m_id + m_n, id);
+				if (it == m_id + m_n || *it != id) return NONE;
+				return (uint32_t)(it - m_id);
+			}
+
+			/**
+			 * write the graph file, returns false on an I/O error
+			 */
+			bool save(FILE * fp) const {
+				uint32_t hdr[6] = {MAGIC, VERSION, (uint32_t)((m_w ? F_WEIGHTED : 0) | (m_id ? F_IDS : 0)), m_n, 0, 0};
+				uint64_t m = edge_count();
+				memcpy(&hdr[4], &m, sizeof(m));
+				return fwrite(hdr, sizeof(hdr), 1, fp) == 1 &&
+					write(fp, m_off, (size_t)m_n + 1) && write(fp, m_tgt, m) &&
+					(!m_w || write(fp, m_w, m)) && (!m_id || write(fp, m_id, m_n));
+			}
+
+			/**
+			 * read a graph file into memory, returns false if it is short or
+			 * not a graph file.
+			 */
+			bool load(FILE * fp) {
+				uint32_t hdr[6];
+				uint64_t m;
+				if (fread(hdr, sizeof(hdr), 1, fp) != 1 || !header(hdr, m)) return false;
+				uint32_t n = hdr[3];
+				CSRGraph g;
+				g.m_n = n;
+				bool ok = read(fp, g.m_offset, (size_t)n + 1) && read(fp, g.m_target, m) &&
+					(!(hdr[2] & F_WEIGHTED) || read(fp, g.m_weight, m)) &&
+					(!(hdr[2] & F_IDS) || read(fp, g.m_ids, n));
+				if (!ok || g.m_offset[0] != 0 || g.m_offset[n] != m) return false;
+				take(g);
+				return true;
+			}
+
+			/**
+			 * use a graph file in place: O(1) whatever its size, only the
+			 * header & the array sizes are checked (see valid()).
+			 * returns false if the file cannot be mapped or is not a graph.
+			 */
+			bool map(const char * path) {
+#ifdef ALGO_CSR_MMAP
+				int fd = open(path, O_RDONLY);
+				if (fd < 0) return false;
+				struct stat st;
+				void * p = MAP_FAILED;
+				if (fstat(fd, &st) == 0 && (size_t)st.st_size >= 6 * sizeof(uint32_t)) {
+					p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+				}
+				close(fd);
+				if (p == MAP_FAILED) return false;
+
+				const uint32_t * hdr = (const uint32_t *)p;
+				const char * base = (const char *)p;
+				size_t size = st.st_size, n = hdr[3], t = 0, w = 0, ids = 0, end = 0;
+				uint64_t m = 0;
+				if (header(hdr, m)) {
+					t = aligned(6 * sizeof(uint32_t)) + aligned((n + 1) * 4);
+					w = t + aligned(m * 4);
+					ids = w + (hdr[2] & F_WEIGHTED ? aligned(m * 4) : 0);
+					end = ids + (hdr[2] & F_IDS ? aligned(n * 4) : 0);
+				}
+				const uint32_t * offset = (const uint32_t *)(base + aligned(6 * sizeof(uint32_t)));
+				if (end == 0 || end > size || offset[0] != 0 || offset[n] != m) {
+					munmap(p, size);
+					return false;
+				}
+
+				unmap();
+				m_offset.clear();
+				m_target.clear();
+				m_weight.clear();
+				m_ids.clear();
+				m_map = p;
+				m_map_size = size;
+				m_n = (uint32_t)n;
+				m_off = offset;
+				m_tgt = (const uint32_t *)(base + t);
+				m_w = hdr[2] & F_WEIGHTED ? (int32_t *)(base + w) : NULL;
+				m_id = hdr[2] & F_IDS ? (const uint32_t *)(base + ids) : NULL;
+				return true;
+#else
+				FILE * fp = fopen(path, "rb");
+				if (!fp) return false;
+				bool ok = load(fp);
+				fclose(fp);
+				return ok;
+#endif
+			}
+
+			/**
+			 * a full check of the arrays, O(V + E): ascending offsets,
+			 * targets in range, ascending ids.
+			 */
+			bool valid() const {
+				if (m_off[0] != 0) return false;
+				for (uint32_t u = 0; u < m_n; u++) {
+					if (m_off[u] > m_off[u + 1]) return false;
+					if (m_id && u > 0 && m_id[u - 1] >= m_id[u]) return false;
+				}
+				uint32_t m = edge_count();
+				for (uint32_t e = 0; e < m; e++) {
+					if (m_tgt[e] >= m_n) return false;
+				}
+				return true;
+			}
+
+			/**
+			 * read a text edge list: one "u v" or "u v weight" per line,
+			 * '#' & '%' start a comment line. the vertex ids are any uint32,
+			 * numbered by ascending id; weighted if any line has a weight,
+			 * the others weigh 1. returns false on a malformed line.
+			 */
+			bool load_edge_list(FILE * fp, bool undirected = false) {
+				std::vector<WeightedEdge> edges;
+				bool has_weight = false;
+				if (!parse_edge_list(fp, edges, has_weight)) return false;
+
+				// renumber the ids: radix sort, then a table of buckets by
+				// the high bits of an id (no more buckets than ids) and a
+				// binary search in the bucket. O(1) on dense ids, O(log n) at
+				// worst, when a few outliers crowd the others in one bucket.
+				std::vector<uint32_t> ids(edges.size() * 2);
+				for (size_t i = 0; i < edges.size(); i++) {
+					ids[2 * i] = edges[i].u;
+					ids[2 * i + 1] = edges[i].v;
+				}
+				if (!ids.empty()) radix_sort(&ids[0], (unsigned)ids.size());
+				ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+				uint32_t shift = 0;
+				uint32_t max_id = ids.empty() ? 0 : ids.back();
+				while ((max_id >> shift) >= ids.size() && shift < 31) shift++;
+				std::vector<uint32_t> bucket(ids.empty() ? 1 : (max_id >> shift) + 2, 0);
+				for (size_t i = 0; i < ids.size(); i++) bucket[(ids[i] >> shift) + 1]++;
+				for (size_t b = 1; b < bucket.size(); b++) bucket[b] += bucket[b - 1];
+				for (size_t i = 0; i < edges.size(); i++) {
+					edges[i].u = remap(ids, bucket, shift, edges[i].u);
+					edges[i].v = remap(ids, bucket, shift, edges[i].v);
+				}
+
+				CSRGraph g;
+				g.m_n = (uint32_t)ids.size();
+				g.build(g.m_n, edges.empty() ? NULL : &edges[0], (uint32_t)edges.size(), undirected);
+				if (!has_weight) g.m_weight.clear();
+				// 0..n-1 need no id array
+				if (!ids.empty() && ids.back() != ids.size() - 1) g.m_ids.swap(ids);
+				take(g);
+				return true;
+			}
+
+		private:
+			/**
+			 * point at the vectors
+			 */
+			void attach() {
+				m_off = &m_offset[0];
+				m_tgt = m_target.empty() ? NULL : &m_target[0];
+				m_w = m_weight.empty() ? NULL : &m_weight[0];
+				m_id = m_ids.empty() ? NULL : &m_ids[0];
+			}
+
+			void copy(const CSRGraph & o) {
+				m_n = o.m_n;
+				m_offset.assign(o.m_off, o.m_off + o.m_n + 1);
+				m_target.assign(o.m_tgt, o.m_tgt + o.edge_count());
+				if (o.m_w) m_weight.assign(o.m_w, o.m_w + o.edge_count());
+				else m_weight.clear();
+				if (o.m_id) m_ids.assign(o.m_id, o.m_id + o.m_n);
+				else m_ids.clear();
+				attach();
+			}
+
+			/**
+			 * the arrays of g, without a copy
+			 */
+			void take(CSRGraph & g) {
+				unmap();
+				m_n = g.m_n;
+				m_offset.swap(g.m_offset);
+				m_target.swap(g.m_target);
+				m_weight.swap(g.m_weight);
+				m_ids.swap(g.m_ids);
+				attach();
+				g.m_offset.assign(1, 0);
+				g.m_n = 0;
+				g.attach();
+			}
+
+			void unmap() {
+#ifdef ALGO_CSR_MMAP
+				if (m_map) munmap(m_map, m_map_size);
+#endif
+				m_map = NULL;
+				m_map_size = 0;
+			}
+
+			void build(uint32_t n, const WeightedEdge edges[], uint32_t m, bool undirected) {
+				m_offset.assign(n + 1, 0);
+				for (uint32_t i = 0; i < m; i++) {
+					m_offset[edges[i].u + 1]++;
+					if (undirected) m_offset[edges[i].v + 1]++;
+				}
+				for (uint32_t u = 0; u < n; u++) m_offset[u + 1] += m_offset[u];
+
+				m_target.resize(m_offset[n]);
+				m_weight.resize(m_offset[n]);
+				std::vector<uint32_t> pos(m_offset.begin(), m_offset.end() - 1);
+				for (uint32_t i = 0; i < m; i++) {
+					uint32_t e = pos[edges[i].u]++;
+					m_target[e] = edges[i].v;
+					m_weight[e] = edges[i].weight;
+					if (undirected) {
+						e = pos[edges[i].v]++;
+						m_target[e] = edges[i].u;
+						m_weight[e] = edges[i].weight;
+					}
+				}
+				m_ids.clear();
+				attach();
+			}
+
+			static inline uint32_t remap(const std::vector<uint32_t> & ids, const std::vector<uint32_t> & bucket,
+					uint32_t shift, uint32_t id) {
+				uint32_t b = id >> shift;
+				return (uint32_t)(std::lower_bound(ids.begin() + bucket[b], ids.begin() + bucket[b + 1], id) - ids.begin());
+			}
+
+			static inline size_t aligned(size_t x) { return (x + 7) & ~(size_t)7; }
+
+			static bool header(const uint32_t hdr[6], uint64_t & m) {
+				memcpy(&m, &hdr[4], sizeof(m));
+				return hdr[0] == MAGIC && hdr[1] == VERSION && m <= UINT32_MAX && hdr[3] < UINT32_MAX;
+			}
+
+			/**
+			 * an array & its padding to 8 bytes
+			 */
+			template<typename T>
+			static bool write(FILE * fp, const T * a, size_t count) {
+				static const char zero[8] = {0};
+				size_t pad = aligned(count * sizeof(T)) - count * sizeof(T);
+				return (count == 0 || fwrite(a, sizeof(T), count, fp) == count) &&
+					(pad == 0 || fwrite(zero, 1, pad, fp) == pad);
+			}
+
+			/**
+			 * count items, a chunk at a time: the memory grows with what the
+			 * file really holds, not with a count from a corrupt header
+			 */
+			template<typename T>
+			static bool read(FILE * fp, std::vector<T> & v, size_t count) {
+				const size_t CHUNK = 1 << 16;
+				char pad[8];
+				size_t npad = aligned(count * sizeof(T)) - count * sizeof(T);
+				v.clear();
+				while (v.size() < count) {
+					size_t at = v.size(), k = std::min(CHUNK, count - at);
+					v.resize(at + k);
+					if (fread(&v[at], sizeof(T), k, fp) != k) return false;
+				}
+				return npad == 0 || fread(pad, 1, npad, fp) == npad;
+			}
+
+			/**
+			 * the lines into edges, by blocks of 1MB & a hand written
+			 * number parser
+			 */
+			static bool parse_edge_list(FILE * fp, std::vector<WeightedEdge> & edges, bool & has_weight) {
+				std::vector<char> buf(1 << 20);
+				size_t len = 0;
+				bool eof = false;
+				while (!eof || len > 0) {
+					if (!eof) {
+						size_t r = fread(&buf[len], 1, buf.size() - len, fp);
+						len += r;
+						eof = r == 0;
+					}
+					// the complete lines in the buffer, all of it at the end
+					size_t last = len;
+					if (!eof) {
+						while (last > 0 && buf[last - 1] != '\n') last--;
+						if (last == 0) {
+							if (len == buf.size()) buf.resize(buf.size() * 2);
+							continue;
+						}
+					}
+					const char * p = &buf[0], * end = p + last;
+					while (p < end) {
+						const char * eol = (const char *)memchr(p, '\n', end - p);
+						if (!eol) eol = end;
+						int64_t x[3];
+						int k = 0;
+						bool comment = false;
+						for (const char * q = p; q < eol;) {
+							if (*q == ' ' || *q == '\t' || *q == '\r' || *q == ',') {
+								q++;
+								continue;
+							}
+							if (k == 0 && (*q == '#' || *q == '%')) {
+								comment = true;
+								break;
+							}
+							if (k == 3) return false;
+							bool neg = *q == '-';
+							if (neg || *q == '+') q++;
+							if (q == eol || *q < '0' || *q > '9') return false;
+							int64_t v = 0;
+							for (; q < eol && *q >= '0' && *q <= '9'; q++) {
+								v = v * 10 + (*q - '0');
+								if (v > UINT32_MAX) return false;
+							}
+							x[k++] = neg ? -v : v;
+						}
+						if (!comment && k > 0) {
+							if (k == 1 || x[0] < 0 || x[1] < 0 || (k == 3 && (x[2] > INT32_MAX || x[2] < INT32_MIN))) return false;
+							WeightedEdge e = {(uint32_t)x[0], (uint32_t)x[1], k == 3 ? (int32_t)x[2] : 1};
+							has_weight = has_weight || k == 3;
+							edges.push_back(e);
+						}
+						p = eol < end ? eol + 1 : end;
+					}
+					memmove(&buf[0], &buf[last], len - last);
+					len -= last;
+					if (eof) break;
+				}
+				return true;
+			}
+	};
+}
+
+#endif //
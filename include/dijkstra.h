@@ -28,12 +28,18 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include <vector>
+
 #include "heap.h"
 #include "directed_graph.h"
+#include "csr_graph.h"
 #include "stack.h"
 #include "hash_table.h"
 
 namespace alg {
+	static const int64_t DIJKSTRA_INF = INT64_MAX;
+	static const uint32_t DIJKSTRA_NONE = UINT32_MAX;
+
 	class Dijkstra {
 		public:
 			static const int UNDEFINED = -1;
@@ -87,6 +93,33 @@ namespace alg {
 
 				return previous;
 			};
+
+			/**
+			 * over a CSRGraph with non-negative weights: dist[v] is the
+			 * distance from src or DIJKSTRA_INF, (*prev)[v] the vertex before
+			 * v or DIJKSTRA_NONE. an indexed heap, every vertex settled once.
+			 */
+			static void run(const CSRGraph & g, uint32_t src, std::vector<int64_t> & dist,
+					std::vector<uint32_t> * prev = NULL) {
+				uint32_t n = g.vertex_count();
+				IndexedHeap<int64_t> Q(n);
+				dist.assign(n, DIJKSTRA_INF);
+				if (prev) prev->assign(n, DIJKSTRA_NONE);
+				dist[src] = 0;
+				Q.push(src, 0);
+				while (!Q.is_empty()) {
+					uint32_t u = Q.pop();
+					for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+						uint32_t v = g.target(e);
+						int64_t alt = dist[u] + g.weight(e);
+						if (alt < dist[v]) {
+							dist[v] = alt;
+							if (prev) (*prev)[v] = u;
+							Q.push(v, alt);
+						}
+					}
+				}
+			}
 	};
 }
 
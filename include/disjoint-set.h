@@ -20,6 +20,11 @@
 
 #ifndef ALGO_DISJOINTSET_H__
 #define ALGO_DISJOINTSET_H__
+#include <stdint.h>
+#include <vector>
+#if __cplusplus >= 201103L
+#include <atomic>
+#endif
 
 namespace alg {
 	template<typename T>
@@ -59,6 +64,148 @@ namespace alg {
 
 			return x->parent;
 		}
+
+	/**
+	 * Index based disjoint-set over elements 0..n-1.
+	 *
+	 * Path halving on find: every other node on the path is pointed to its
+	 * grandparent, in one pass and without recursion. Union by size keeps
+	 * the trees shallow. Both together give O(alpha(n)) amortized.
+	 */
+	class DisjointSet {
+		private:
+			std::vector<uint32_t> m_parent;
+			std::vector<uint32_t> m_size;	// valid for roots only
+			uint32_t m_sets;
+
+		public:
+			explicit DisjointSet(uint32_t n) : m_parent(n), m_size(n, 1), m_sets(n) {
+				for (uint32_t i = 0; i < n; i++) m_parent[i] = i;
+			}
+
+			uint32_t find(uint32_t x) {
+				while (m_parent[x] != x) {
+					m_parent[x] = m_parent[m_parent[x]];
+					x = m_parent[x];
+				}
+				return x;
+			}
+
+			/**
+			 * merge the sets of x & y, returns false if already the same set
+			 */
+			bool unite(uint32_t x, uint32_t y) {
+				x = find(x);
+				y = find(y);
+				if (x == y) return false;
+				if (m_size[x] < m_size[y]) { uint32_t t = x; x = y; y = t; }
+				m_parent[y] = x;
+				m_size[x] += m_size[y];
+				m_sets--;
+				return true;
+			}
+
+			bool same(uint32_t x, uint32_t y) { return find(x) == find(y); }
+
+			// the size of the set containing x
+			uint32_t set_size(uint32_t x) { return m_size[find(x)]; }
+
+			// the number of disjoint sets
+			uint32_t count() const { return m_sets; }
+
+			uint32_t size() const { return (uint32_t)m_parent.size(); }
+	};
+
+#if __cplusplus >= 201103L
+	/**
+	 * Lock-free disjoint-set, safe for concurrent find/unite/same.
+	 *
+	 * Roots are linked with a CAS on the parent slot, the root with the lower
+	 * (pseudo random) priority goes below the other one, so no size has to be
+	 * kept consistent. Path halving is done with a CAS too, a failed CAS just
+	 * means another thread already shortened that path.
+	 *
+	 * Jayanti & Tarjan, Concurrent Disjoint Set Union, 2016
+	 */
+	class ConcurrentDisjointSet {
+		private:
+			std::atomic<uint32_t> * m_parent;
+			uint32_t m_n;
+			std::atomic<uint32_t> m_sets;
+
+			ConcurrentDisjointSet(const ConcurrentDisjointSet &);
+			ConcurrentDisjointSet& operator=(const ConcurrentDisjointSet &);
+
+		public:
+			explicit ConcurrentDisjointSet(uint32_t n) : m_parent(new std::atomic<uint32_t>[n]), m_n(n), m_sets(n) {
+				for (uint32_t i = 0; i < n; i++) m_parent[i].store(i, std::memory_order_relaxed);
+			}
+
+			~ConcurrentDisjointSet() { delete [] m_parent; }
+
+			uint32_t find(uint32_t x) {
+				while (true) {
+					uint32_t p = m_parent[x].load(std::memory_order_acquire);
+					if (p == x) return x;
+					uint32_t gp = m_parent[p].load(std::memory_order_acquire);
+					if (p != gp) {
+						m_parent[x].compare_exchange_weak(p, gp, std::memory_order_release, std::memory_order_relaxed);
+					}
+					x = gp;
+				}
+			}
+
+			/**
+			 * merge the sets of x & y, returns false if already the same set
+			 */
+			bool unite(uint32_t x, uint32_t y) {
+				while (true) {
+					x = find(x);
+					y = find(y);
+					if (x == y) return false;
+					if (less(y, x)) { uint32_t t = x; x = y; y = t; }
+
+					// x is the lower one, it must still be a root to be linked
+					uint32_t expected = x;
+					if (m_parent[x].compare_exchange_strong(expected, y, std::memory_order_acq_rel)) {
+						m_sets.fetch_sub(1, std::memory_order_relaxed);
+						return true;
+					}
+				}
+			}
+
+			bool same(uint32_t x, uint32_t y) {
+				while (true) {
+					x = find(x);
+					y = find(y);
+					if (x == y) return true;
+					// x may have been linked after find(x), re-check
+					if (m_parent[x].load(std::memory_order_acquire) == x) return false;
+				}
+			}
+
+			// the number of disjoint sets
+			uint32_t count() const { return m_sets.load(std::memory_order_relaxed); }
+
+			uint32_t size() const { return m_n; }
+
+		private:
+			// a fixed random-looking total order on the elements
+			static inline uint32_t priority(uint32_t x) {
+				x ^= x >> 16;
+				x *= 0x7feb352d;
+				x ^= x >> 15;
+				x *= 0x846ca68b;
+				x ^= x >> 16;
+				return x;
+			}
+
+			static inline bool less(uint32_t a, uint32_t b) {
+				uint32_t pa = priority(a), pb = priority(b);
+				return pa < pb || (pa == pb && a < b);
+			}
+	};
+#endif
 }
 
 #endif //
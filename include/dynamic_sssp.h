@@ -0,0 +1,295 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * DYNAMIC SINGLE SOURCE SHORTEST PATHS
+ *
+ * Features:
+ * 1. keeps the shortest path tree from a source while edges are added,
+ *    deleted or re-weighted, non negative weights, O(1) distance queries.
+ * 2. a batch of changes is repaired at once (Ramalingam & Reps):
+ *    - the vertices whose tree edge got heavier or went away are examined
+ *      in the order of their old distance; one with another in-edge still
+ *      giving the same distance just switches parent, otherwise it is
+ *      affected and so are its tree children.
+ *    - every affected vertex restarts from its best in-edge coming from an
+ *      unaffected vertex, the heads of the lighter & new edges are lowered,
+ *      then a Dijkstra limited to what changed settles the rest.
+ *    the work is bounded by the part of the tree whose distances changed,
+ *    instead of the whole graph.
+ * 3. one edge per ordered pair of vertices, as DirectedGraph
+ *
+ * http://en.wikipedia.org/wiki/Dynamic_problem_(algorithms)
+ * Ramalingam & Reps, An Incremental Algorithm for a Generalization of the
+ * Shortest-Path Problem, 1996
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_DYNAMIC_SSSP_H__
+#define ALGO_DYNAMIC_SSSP_H__
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "heap.h"
+#include "csr_graph.h"
+
+namespace alg {
+	static const uint32_t SSSP_NONE = UINT32_MAX;
+	static const int64_t SSSP_INF = INT64_MAX;
+
+	class DynamicSSSP {
+		private:
+			struct Edge {
+				uint32_t u;
+				uint32_t v;
+				int32_t weight;
+				bool alive;
+				bool changed;		// since the last repair
+			};
+
+			uint32_t m_n;
+			uint32_t m_src;
+			std::vector<Edge> m_edges;
+			std::vector<uint32_t> m_free;		// ids of deleted edges, once repaired
+			std::vector<std::vector<uint32_t> > m_out;	// edge ids by tail
+			std::vector<std::vector<uint32_t> > m_in;	// edge ids by head
+			std::vector<uint32_t> m_changed;
+
+			std::vector<int64_t> m_dist;
+			std::vector<uint32_t> m_prev;		// tree edge into a vertex, or SSSP_NONE
+			std::vector<uint8_t> m_affected;
+			std::vector<uint32_t> m_list;
+			IndexedHeap<int64_t> m_heap;
+
+		public:
+			/**
+			 * vertices 0..n-1 without edges, src the source
+			 */
+			DynamicSSSP(uint32_t n, uint32_t src) : m_n(n), m_src(src), m_out(n), m_in(n),
+				m_dist(n, SSSP_INF), m_prev(n, SSSP_NONE), m_affected(n, 0), m_heap(n) {
+				if (src >= n) throw std::out_of_range("source out of range");
+				m_dist[src] = 0;
+			}
+
+			/**
+			 * start from the edges of a CSRGraph, parallel edges keep the
+			 * lightest.
+			 */
+			DynamicSSSP(const CSRGraph & g, uint32_t src) : m_n(g.vertex_count()), m_src(src),
+				m_out(g.vertex_count()), m_in(g.vertex_count()),
+				m_dist(g.vertex_count(), SSSP_INF), m_prev(g.vertex_count(), SSSP_NONE),
+				m_affected(g.vertex_count(), 0), m_heap(g.vertex_count()) {
+				if (src >= m_n) throw std::out_of_range("source out of range");
+				for (uint32_t u = 0; u < m_n; u++) {
+					for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+						uint32_t id = find(u, g.target(e));
+						if (id == SSSP_NONE) add_edge(u, g.target(e), g.weight(e));
+						else if (g.weight(e) < m_edges[id].weight) set_weight(u, g.target(e), g.weight(e));
+					}
+				}
+				m_dist[src] = 0;
+				update();
+			}
+
+			/**
+			 * add an edge for u -> v, false if it exists already
+			 */
+			bool add_edge(uint32_t u, uint32_t v, int32_t weight) {
+				check(u, v, weight);
+				if (find(u, v) != SSSP_NONE) return false;
+				Edge e = {u, v, weight, true, false};
+				uint32_t id;
+				if (m_free.empty()) {
+					id = (uint32_t)m_edges.size();
+					m_edges.push_back(e);
+				} else {
+					id = m_free.back();
+					m_free.pop_back();
+					m_edges[id] = e;
+				}
+				m_out[u].push_back(id);
+				m_in[v].push_back(id);
+				mark(id);
+				return true;
+			}
+
+			/**
+			 * delete the edge u -> v, false if there is none
+			 */
+			bool delete_edge(uint32_t u, uint32_t v) {
+				if (u >= m_n || v >= m_n) throw std::out_of_range("vertex out of range");
+				uint32_t id = find(u, v);
+				if (id == SSSP_NONE) return false;
+				m_edges[id].alive = false;
+				unlink(m_out[u], id);
+				unlink(m_in[v], id);
+				mark(id);
+				return true;
+			}
+
+			/**
+			 * change the weight of u -> v, false if there is no such edge
+			 */
+			bool set_weight(uint32_t u, uint32_t v, int32_t weight) {
+				check(u, v, weight);
+				uint32_t id = find(u, v);
+				if (id == SSSP_NONE) return false;
+				m_edges[id].weight = weight;
+				mark(id);
+				return true;
+			}
+
+			/**
+			 * repair the tree after the changes since the last call,
+			 * returns the number of vertices settled again.
+			 */
+			uint32_t update() {
+				// heavier or deleted tree edges
+				for (size_t i = 0; i < m_changed.size(); i++) {
+					const Edge & e = m_edges[m_changed[i]];
+					if (m_prev[e.v] != m_changed[i]) continue;
+					if (!e.alive || m_dist[e.u] + e.weight > m_dist[e.v]) m_heap.push(e.v, m_dist[e.v]);
+				}
+				find_affected();
+
+				// the affected restart from the unaffected in-neighbours
+				for (size_t i = 0; i < m_list.size(); i++) {
+					m_dist[m_list[i]] = SSSP_INF;
+					m_prev[m_list[i]] = SSSP_NONE;
+				}
+				for (size_t i = 0; i < m_list.size(); i++) {
+					uint32_t v = m_list[i];
+					const std::vector<uint32_t> & in = m_in[v];
+					for (size_t k = 0; k < in.size(); k++) {
+						const Edge & e = m_edges[in[k]];
+						if (m_dist[e.u] != SSSP_INF) lower(v, m_dist[e.u] + e.weight, in[k]);
+					}
+					m_affected[v] = 0;
+				}
+				m_list.clear();
+
+				// lighter & new edges
+				for (size_t i = 0; i < m_changed.size(); i++) {
+					uint32_t id = m_changed[i];
+					Edge & e = m_edges[id];
+					e.changed = false;
+					if (!e.alive) {
+						m_free.push_back(id);
+						continue;
+					}
+					if (m_dist[e.u] != SSSP_INF) lower(e.v, m_dist[e.u] + e.weight, id);
+				}
+				m_changed.clear();
+
+				uint32_t settled = 0;
+				while (!m_heap.is_empty()) {
+					uint32_t u = m_heap.pop();
+					settled++;
+					const std::vector<uint32_t> & out = m_out[u];
+					for (size_t k = 0; k < out.size(); k++) {
+						const Edge & e = m_edges[out[k]];
+						lower(e.v, m_dist[u] + e.weight, out[k]);
+					}
+				}
+				return settled;
+			}
+
+			inline uint32_t vertex_count() const { return m_n; }
+			inline uint32_t source() const { return m_src; }
+
+			/**
+			 * the distance of v as of the last update(), SSSP_INF if unreachable
+			 */
+			inline int64_t dist(uint32_t v) const { return m_dist[v]; }
+
+			/**
+			 * the vertex before v on its shortest path, SSSP_NONE if none
+			 */
+			inline uint32_t prev(uint32_t v) const {
+				return m_prev[v] == SSSP_NONE ? SSSP_NONE : m_edges[m_prev[v]].u;
+			}
+
+			/**
+			 * the shortest path from the source to v, empty if unreachable
+			 */
+			void path(uint32_t v, std::vector<uint32_t> & p) const {
+				p.clear();
+				if (m_dist[v] == SSSP_INF) return;
+				for (; v != SSSP_NONE; v = prev(v)) p.push_back(v);
+				std::reverse(p.begin(), p.end());
+			}
+
+		private:
+			void check(uint32_t u, uint32_t v, int32_t weight) const {
+				if (u >= m_n || v >= m_n) throw std::out_of_range("vertex out of range");
+				if (weight < 0) throw std::invalid_argument("negative weight");
+			}
+
+			uint32_t find(uint32_t u, uint32_t v) const {
+				const std::vector<uint32_t> & out = m_out[u];
+				for (size_t k = 0; k < out.size(); k++) {
+					if (m_edges[out[k]].v == v) return out[k];
+				}
+				return SSSP_NONE;
+			}
+
+			static void unlink(std::vector<uint32_t> & list, uint32_t id) {
+				std::vector<uint32_t>::iterator it = std::find(list.begin(), list.end(), id);
+				*it = list.back();
+				list.pop_back();
+			}
+
+			inline void mark(uint32_t id) {
+				if (!m_edges[id].changed) {
+					m_edges[id].changed = true;
+					m_changed.push_back(id);
+				}
+			}
+
+			inline void lower(uint32_t v, int64_t d, uint32_t edge) {
+				if (d < m_dist[v]) {
+					m_dist[v] = d;
+					m_prev[v] = edge;
+					m_heap.push(v, d);
+				}
+			}
+
+			/**
+			 * pop the examined vertices by old distance, a parent is settled
+			 * before its children. an in-edge from an unaffected vertex at
+			 * the same distance saves v; zero weight edges are not trusted,
+			 * their tail may be at the same distance & still unexamined.
+			 */
+			void find_affected() {
+				while (!m_heap.is_empty()) {
+					uint32_t v = m_heap.pop();
+					const std::vector<uint32_t> & in = m_in[v];
+					uint32_t alt = SSSP_NONE;
+					for (size_t k = 0; k < in.size() && alt == SSSP_NONE; k++) {
+						const Edge & e = m_edges[in[k]];
+						if (e.weight > 0 && !m_affected[e.u] && m_dist[e.u] != SSSP_INF &&
+								m_dist[e.u] + e.weight == m_dist[v]) alt = in[k];
+					}
+					if (alt != SSSP_NONE) {
+						m_prev[v] = alt;
+						continue;
+					}
+
+					m_affected[v] = 1;
+					m_list.push_back(v);
+					const std::vector<uint32_t> & out = m_out[v];
+					for (size_t k = 0; k < out.size(); k++) {
+						uint32_t x = m_edges[out[k]].v;
+						if (m_prev[x] == out[k] && !m_affected[x]) m_heap.push(x, m_dist[x]);
+					}
+				}
+			}
+	};
+}
+
+#endif //
@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * STATIC SEARCH TREE (EYTZINGER LAYOUT)
+ *
+ * Features:
+ * 1. built once from a sorted array in O(n), read-only afterwards
+ * 2. keys stored in BFS order: the children of slot k are 2k and 2k+1,
+ *    no pointers, the top levels of the tree share a few cache lines
+ * 3. branchless descent, the comparison result becomes the next index
+ * 4. the descendants sharing one cache line a few levels below are
+ *    prefetched while descending
+ * 5. batched lookups, interleaving several searches to hide memory latency
+ *
+ * http://en.wikipedia.org/wiki/Binary_heap#Heap_implementation
+ * Khuong & Morin, Array Layouts for Comparison-Based Searching, 2015
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_EYTZINGER_H__
+#define ALGO_EYTZINGER_H__
+#include <stdlib.h>
+#include <stdint.h>
+#include <new>
+#include <stdexcept>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define EYTZ_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define EYTZ_PREFETCH(addr)
+#endif
+
+namespace alg {
+	template<typename KeyT, typename ValueT>
+	class Eytzinger {
+	private:
+		static const uint32_t CACHE_LINE = 64;
+		// keys per cache line, rounded down to a power of 2
+		static const uint32_t BLOCK = sizeof(KeyT) >= CACHE_LINE ? 1 :
+			sizeof(KeyT) > CACHE_LINE / 2 ? 1 :
+			sizeof(KeyT) > CACHE_LINE / 4 ? 2 :
+			sizeof(KeyT) > CACHE_LINE / 8 ? 4 :
+			sizeof(KeyT) > CACHE_LINE / 16 ? 8 : 16;
+		static const uint32_t BATCH = 16;	// searches interleaved in a batch
+
+		uint32_t m_n;		// number of keys
+		uint32_t m_full;	// number of full levels
+		void * m_raw;		// unaligned allocation
+		KeyT * m_keys;		// keys[1..n] in eytzinger order, cache-line aligned
+		ValueT * m_values;	// values[1..n] in the same order
+
+	public:
+		/**
+		 * build from `n` sorted keys & their values.
+		 */
+		Eytzinger(const KeyT keys[], const ValueT values[], uint32_t n) : m_n(n), m_full(0) {
+			if (n >= 0x80000000u)
+				throw std::length_error ("too many keys");
+			for (uint32_t i = 1; i < n; i++) {
+				if (keys[i] < keys[i-1])
+					throw std::invalid_argument ("keys are not sorted");
+			}
+
+			while (((uint64_t)2 << m_full) - 1 <= n) m_full++;
+
+			// slot 0 is unused, align &keys[0] so that keys[B*k .. B*k+B-1]
+			// sit in one cache line.
+			m_raw = malloc((size_t)(n + 1) * sizeof(KeyT) + CACHE_LINE);
+			if (m_raw == NULL) throw std::bad_alloc();
+			uintptr_t p = ((uintptr_t)m_raw + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+			m_keys = (KeyT *)p;
+			m_values = new ValueT[n + 1];
+
+			uint32_t i = 0;
+			build(keys, values, i, 1);
+		}
+
+		~Eytzinger() {
+			for (uint32_t k = 1; k <= m_n; k++) m_keys[k].~KeyT();
+			free(m_raw);
+			delete [] m_values;
+		}
+
+	private:
+		Eytzinger(const Eytzinger &);
+		Eytzinger& operator=(const Eytzinger &);
+
+	public:
+		uint32_t size() const { return m_n; }
+
+		/**
+		 * the slot of the first key not less than `key`, 0 if there is none.
+		 */
+		uint32_t lower_bound(const KeyT & key) const {
+			uint32_t k = 1;
+			// every path has m_full levels, no bound check needed
+			for (uint32_t lvl = 0; lvl < m_full; lvl++) {
+				EYTZ_PREFETCH(m_keys + (uint64_t)k * BLOCK);
+				k = 2 * k + (m_keys[k] < key);
+			}
+			// the last, incomplete level
+			if (k <= m_n) k = 2 * k + (m_keys[k] < key);
+			return finish(k);
+		}
+
+		/**
+		 * lookup a key, returns false if not found.
+		 */
+		bool find(const KeyT & key, ValueT & value) const {
+			uint32_t k = lower_bound(key);
+			if (k == 0 || key < m_keys[k]) return false;
+			value = m_values[k];
+			return true;
+		}
+
+		/**
+		 * lower_bound() for `n` keys, written to `slots`.
+		 * the searches are interleaved in groups, so that the cache misses of
+		 * one search overlap with the others.
+		 */
+		void lower_bound_batch(const KeyT keys[], uint32_t n, uint32_t slots[]) const {
+			for (uint32_t base = 0; base < n; base += BATCH) {
+				uint32_t cnt = n - base < BATCH ? n - base : BATCH;
+				const KeyT * q = keys + base;
+				uint32_t * k = slots + base;
+
+				for (uint32_t j = 0; j < cnt; j++) k[j] = 1;
+				for (uint32_t lvl = 0; lvl < m_full; lvl++) {
+					for (uint32_t j = 0; j < cnt; j++) {
+						EYTZ_PREFETCH(m_keys + (uint64_t)k[j] * BLOCK);
+						k[j] = 2 * k[j] + (m_keys[k[j]] < q[j]);
+					}
+				}
+				for (uint32_t j = 0; j < cnt; j++) {
+					if (k[j] <= m_n) k[j] = 2 * k[j] + (m_keys[k[j]] < q[j]);
+					k[j] = finish(k[j]);
+				}
+			}
+		}
+
+		/**
+		 * find() for `n` keys, found[i] tells whether values[i] is set.
+		 */
+		void find_batch(const KeyT keys[], uint32_t n, ValueT values[], bool found[]) const {
+			uint32_t slots[BATCH];
+			for (uint32_t base = 0; base < n; base += BATCH) {
+				uint32_t cnt = n - base < BATCH ? n - base : BATCH;
+				lower_bound_batch(keys + base, cnt, slots);
+				for (uint32_t j = 0; j < cnt; j++) {
+					uint32_t k = slots[j];
+					found[base + j] = k != 0 && !(keys[base + j] < m_keys[k]);
+					if (found[base + j]) values[base + j] = m_values[k];
+				}
+			}
+		}
+
+		/**
+		 * access by slot, as returned by lower_bound()
+		 */
+		const KeyT & key(uint32_t slot) const { return m_keys[slot]; }
+		const ValueT & value(uint32_t slot) const { return m_values[slot]; }
+
+	private:
+		/**
+		 * in-order traversal of the implicit tree, taking keys in sorted order
+		 */
+		void build(const KeyT keys[], const ValueT values[], uint32_t & i, uint32_t k) {
+			if (k > m_n) return;
+			build(keys, values, i, 2 * k);
+			new (&m_keys[k]) KeyT(keys[i]);
+			m_values[k] = values[i];
+			i++;
+			build(keys, values, i, 2 * k + 1);
+		}
+
+		/**
+		 * the descent went right (1) after passing the answer, then left (0)
+		 * until falling off the tree, strip the trailing 1s and that 0.
+		 * all 1s: right all the way down a full tree, no answer.
+		 */
+		static inline uint32_t finish(uint32_t k) {
+			if (~k == 0) return 0;
+			return (uint32_t)((uint64_t)k >> (ctz(~k) + 1));
+		}
+
+		static inline uint32_t ctz(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_ctz(x);
+#else
+			uint32_t n = 0;
+			while (!(x & 1)) { x >>= 1; n++; }
+			return n;
+#endif
+		}
+	};
+}
+
+#endif //
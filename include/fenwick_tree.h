@@ -7,8 +7,15 @@
  * - RSQ - This function calculates the range sum query in O(log n)
  * - Update - This function adjusts the values in the given range in O(log n)
  *
+ * Variants:
+ * - BasicFenwick<T> - any summable value type, O(n) construction from an array
+ * - RangeFenwick<T> - range update & range query with two trees
+ * - Fenwick2D<T>    - point update & rectangle sum on a grid in O(log n * log m)
+ * - BlockPrefixSum<T> - sqrt-decomposed prefix sums, O(1) query and
+ *                       O(sqrt n) update with contiguous, vectorizable loops
+ *
  * https://en.wikipedia.org/wiki/Fenwick_tree
- * 
+ *
  * @author Gabriel Duarte (gabriellagoa10@yahoo.com.br)
  * @github Gabriel123Duarte
  *
@@ -18,43 +25,209 @@
 #define ALGO_FENWICK_H__
 
 #include <vector>
+#include <math.h>
 
 #define LSONE(x) (x & (-x))
 
-class Fenwick
+template<typename T>
+class BasicFenwick
 {
 	private:
 		// Vector representing the table
-		std::vector<int> fen;
+		std::vector<T> fen;
 	public:
-		Fenwick() {}
+		BasicFenwick() {}
 
 		// We don't use the index 0, because it is the base case
-		Fenwick(int n)
+		BasicFenwick(int n)
 		{
-			fen.assign(n + 1, 0);
+			fen.assign(n + 1, T());
 		}
 
-		// Calculate the 
-		int rsq(int a)
+		// Build from a[0..n-1] in O(n), each node pushes its sum to its parent
+		BasicFenwick(const T a[], int n)
 		{
-			int ans = 0;
+			fen.assign(n + 1, T());
+			for(int i = 1; i <= n; i++)
+				fen[i] += a[i - 1];
+			for(int i = 1; i <= n; i++) {
+				int j = i + LSONE(i);
+				if(j <= n)
+					fen[j] += fen[i];
+			}
+		}
+
+		int size() const { return (int)fen.size() - 1; }
+
+		// Calculate the
+		T rsq(int a) const
+		{
+			T ans = T();
 			for(; a; a -= LSONE(a))
 				ans += fen[a];
 			return ans;
 		}
 
 		// RSQ a..b
-		inline int rsq(int a, int b)
+		inline T rsq(int a, int b) const
 		{
-			return rsq(b) - (a == 1 ? 0 : rsq(a - 1));
+			return rsq(b) - (a == 1 ? T() : rsq(a - 1));
 		}
 
 		// Update the value of the k-th element by x
-		void update(int k, int x)
+		void update(int k, T x)
 		{
 			for(; k < (int)fen.size(); k += LSONE(k))
-				fen[k] += x;	
+				fen[k] += x;
+		}
+};
+
+typedef BasicFenwick<int> Fenwick;
+
+// Range update & range query.
+// With B1, B2 tracking a difference array d, the prefix sum is
+// sum(1..i) = B1(i) * i - B2(i)
+template<typename T>
+class RangeFenwick
+{
+	private:
+		BasicFenwick<T> b1, b2;
+	public:
+		RangeFenwick(int n) : b1(n), b2(n) {}
+
+		// Add x to every element in l..r
+		void update(int l, int r, T x)
+		{
+			b1.update(l, x);
+			b1.update(r + 1, -x);
+			b2.update(l, x * (T)(l - 1));
+			b2.update(r + 1, -x * (T)r);
+		}
+
+		T rsq(int a) const
+		{
+			return b1.rsq(a) * (T)a - b2.rsq(a);
+		}
+
+		// RSQ a..b
+		inline T rsq(int a, int b) const
+		{
+			return rsq(b) - (a == 1 ? T() : rsq(a - 1));
+		}
+};
+
+// 2D Fenwick tree over a n x m grid, stored row-major in one vector
+template<typename T>
+class Fenwick2D
+{
+	private:
+		int n, m;
+		std::vector<T> fen;
+	public:
+		Fenwick2D(int n, int m) : n(n), m(m)
+		{
+			fen.assign((size_t)(n + 1) * (m + 1), T());
+		}
+
+		// Sum of the rectangle (1,1)..(x,y)
+		T rsq(int x, int y) const
+		{
+			T ans = T();
+			for(; x; x -= LSONE(x))
+				for(int j = y; j; j -= LSONE(j))
+					ans += fen[(size_t)x * (m + 1) + j];
+			return ans;
+		}
+
+		// Sum of the rectangle (x1,y1)..(x2,y2)
+		T rsq(int x1, int y1, int x2, int y2) const
+		{
+			return rsq(x2, y2) - rsq(x1 - 1, y2) - rsq(x2, y1 - 1) + rsq(x1 - 1, y1 - 1);
+		}
+
+		// Update the value of the cell (x, y) by v
+		void update(int x, int y, T v)
+		{
+			for(; x <= n; x += LSONE(x))
+				for(int j = y; j <= m; j += LSONE(j))
+					fen[(size_t)x * (m + 1) + j] += v;
+		}
+};
+
+// Block decomposed prefix sums, to compare against Fenwick.
+// inner[i] is the prefix sum within the block of i, outer[b] is the sum of
+// all blocks before b. A query reads two numbers, an update adds a constant
+// to the tail of one block and to the tail of outer: plain loops over
+// contiguous memory the compiler turns into SIMD adds.
+template<typename T>
+class BlockPrefixSum
+{
+	private:
+		int n, bs;
+		std::vector<T> inner;
+		std::vector<T> outer;
+
+		static void add(T * p, int len, T x)
+		{
+			for(int i = 0; i < len; i++)
+				p[i] += x;
+		}
+	public:
+		BlockPrefixSum(int n) : n(n), bs(block_size(n))
+		{
+			inner.assign(n + 1, T());
+			outer.assign(n / bs + 2, T());
+		}
+
+		// Build from a[0..n-1] in O(n)
+		BlockPrefixSum(const T a[], int n) : n(n), bs(block_size(n))
+		{
+			inner.assign(n + 1, T());
+			outer.assign(n / bs + 2, T());
+			T total = T();
+			for(int i = 0; i < n; i++) {
+				if(i % bs == 0) {
+					outer[i / bs] = total;
+					inner[i] = a[i];
+				} else {
+					inner[i] = inner[i - 1] + a[i];
+				}
+				total += a[i];
+			}
+			for(int b = (n - 1) / bs + 1; b < (int)outer.size(); b++)
+				outer[b] = total;
+		}
+
+		// Sum of 1..a, same indexing as Fenwick
+		inline T rsq(int a) const
+		{
+			if(a == 0) return T();
+			return outer[(a - 1) / bs] + inner[a - 1];
+		}
+
+		// RSQ a..b
+		inline T rsq(int a, int b) const
+		{
+			return rsq(b) - rsq(a - 1);
+		}
+
+		// Update the value of the k-th element by x
+		void update(int k, T x)
+		{
+			int i = k - 1;
+			int b = i / bs;
+			int end = (b + 1) * bs < n ? (b + 1) * bs : n;
+			add(&inner[i], end - i, x);
+			add(&outer[b + 1], (int)outer.size() - b - 1, x);
+		}
+
+	private:
+		// ~sqrt(n), rounded up to a multiple of 16 for full vector lanes
+		static int block_size(int n)
+		{
+			int s = (int)sqrt((double)n);
+			if(s < 16) s = 16;
+			return (s + 15) / 16 * 16;
 		}
 };
 
@@ -0,0 +1,297 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * ALL PAIRS SHORTEST PATHS
+ *
+ * Features:
+ * 1. floyd_warshall: the distance matrix in place, O(V^3).
+ *    the matrix is cut in BxB blocks, and every round k over a block
+ *    column goes in three phases: the diagonal block, then the blocks in
+ *    its row & column, then all the others. a block update only reads
+ *    three blocks that stay in cache, and the innermost loop is a
+ *    branch-free min over a row, that the compiler turns into SIMD.
+ *    the blocks of a phase are independent and shared by nthreads
+ *    threads (C++11).
+ * 2. johnson: for sparse graphs, O(VE logV). SPFA from a virtual source
+ *    gives potentials h, the weights w(u,v) + h(u) - h(v) are non
+ *    negative, and a Dijkstra runs from every vertex, the sources spread
+ *    over the threads.
+ *
+ * Distances are int32_t, FW_INF for no path. Every path must weigh less
+ * than FW_INF / 2 in absolute value. Both return false on a negative cycle.
+ *
+ * http://en.wikipedia.org/wiki/Floyd%E2%80%93Warshall_algorithm
+ * http://en.wikipedia.org/wiki/Johnson%27s_algorithm
+ * Venkataraman, Sahni & Mukhopadhyaya, A Blocked All-Pairs Shortest-Paths
+ * Algorithm, 2003
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_FLOYD_WARSHALL_H__
+#define ALGO_FLOYD_WARSHALL_H__
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#endif
+
+#include "2darray.h"
+#include "csr_graph.h"
+#include "dijkstra.h"		// before bellman_ford.h, which defines UNDEFINED
+#include "bellman_ford.h"
+
+namespace alg {
+	static const int32_t FW_INF = INT32_MAX / 2;		// FW_INF + FW_INF does not overflow
+
+	namespace detail {
+		static const uint32_t FW_BLOCK = 64;		// 3 blocks of 16KB for an update
+
+		/**
+		 * c[i][j] = min(c[i][j], a[i][k] + b[k][j]), k in order; the blocks
+		 * may be the same one (diagonal & its row / column). the sums stop
+		 * at -FW_INF / 2: around a negative cycle they would go down
+		 * round after round, until they overflow.
+		 */
+		static inline void fw_block_k(int32_t * c, const int32_t * a, const int32_t * b,
+				uint32_t ni, uint32_t nj, uint32_t nk, uint32_t stride) {
+			for (uint32_t k = 0; k < nk; k++) {
+				const int32_t * bk = b + (size_t)k * stride;
+				for (uint32_t i = 0; i < ni; i++) {
+					int32_t aik = a[(size_t)i * stride + k];
+					if (aik >= FW_INF / 2) continue;
+					int32_t * ci = c + (size_t)i * stride;
+					for (uint32_t j = 0; j < nj; j++) {
+						int32_t s = aik + bk[j];
+						s = s < -FW_INF / 2 ? -FW_INF / 2 : s;
+						ci[j] = s < ci[j] ? s : ci[j];
+					}
+				}
+			}
+		}
+
+		/**
+		 * the same for a block distinct from a & b, which are final: the
+		 * row of c stays in L1 while the rows of b stream by.
+		 */
+		static inline void fw_block_i(int32_t * c, const int32_t * a, const int32_t * b,
+				uint32_t ni, uint32_t nj, uint32_t nk, uint32_t stride) {
+			for (uint32_t i = 0; i < ni; i++) {
+				int32_t * ci = c + (size_t)i * stride;
+				const int32_t * ai = a + (size_t)i * stride;
+				for (uint32_t k = 0; k < nk; k++) {
+					int32_t aik = ai[k];
+					if (aik >= FW_INF / 2) continue;
+					const int32_t * bk = b + (size_t)k * stride;
+					for (uint32_t j = 0; j < nj; j++) {
+						int32_t s = aik + bk[j];
+						s = s < -FW_INF / 2 ? -FW_INF / 2 : s;
+						ci[j] = s < ci[j] ? s : ci[j];
+					}
+				}
+			}
+		}
+
+		/**
+		 * one phase of round kb: block t, t + nthreads ... of the phase.
+		 * phase 0 the diagonal, 1 its row & column, 2 the rest.
+		 */
+		static void fw_phase(Array2D<int32_t> & d, uint32_t kb, int phase, uint32_t t, uint32_t nthreads) {
+			const uint32_t B = FW_BLOCK;
+			uint32_t n = d.row(), nb = (n + B - 1) / B;
+			uint32_t k0 = kb * B, nk = std::min(B, n - k0);
+			int32_t * base = d[0];
+			const uint32_t stride = n;
+			int32_t * dkk = base + (size_t)k0 * stride + k0;
+
+			if (phase == 0) {
+				if (t == 0) fw_block_k(dkk, dkk, dkk, nk, nk, nk, stride);
+			} else if (phase == 1) {
+				// row blocks (kb, j) & column blocks (i, kb)
+				for (uint32_t x = t; x < 2 * nb; x += nthreads) {
+					uint32_t b = x % nb;
+					if (b == kb) continue;
+					uint32_t o = b * B, no = std::min(B, n - o);
+					if (x < nb) {
+						int32_t * c = base + (size_t)k0 * stride + o;
+						fw_block_k(c, dkk, c, nk, no, nk, stride);
+					} else {
+						int32_t * c = base + (size_t)o * stride + k0;
+						fw_block_k(c, c, dkk, no, nk, nk, stride);
+					}
+				}
+			} else {
+				for (uint32_t ib = t; ib < nb; ib += nthreads) {
+					if (ib == kb) continue;
+					uint32_t i0 = ib * B, ni = std::min(B, n - i0);
+					const int32_t * a = base + (size_t)i0 * stride + k0;
+					for (uint32_t jb = 0; jb < nb; jb++) {
+						if (jb == kb) continue;
+						uint32_t j0 = jb * B, nj = std::min(B, n - j0);
+						fw_block_i(base + (size_t)i0 * stride + j0, a, base + (size_t)k0 * stride + j0,
+								ni, nj, nk, stride);
+					}
+				}
+			}
+		}
+
+		/**
+		 * a negative cycle through the diagonal block of round kb, after
+		 * its phase 0
+		 */
+		static bool fw_negative(Array2D<int32_t> & d, uint32_t kb) {
+			uint32_t k0 = kb * FW_BLOCK, nk = std::min(FW_BLOCK, d.row() - k0);
+			for (uint32_t k = k0; k < k0 + nk; k++) {
+				if (d(k, k) < 0) return true;
+			}
+			return false;
+		}
+
+		/**
+		 * back to FW_INF what only a missing edge could give, and check
+		 * the diagonal
+		 */
+		static bool fw_finish(Array2D<int32_t> & d) {
+			uint32_t n = d.row();
+			bool ok = true;
+			for (uint32_t i = 0; i < n; i++) {
+				int32_t * di = d[i];
+				for (uint32_t j = 0; j < n; j++) {
+					if (di[j] >= FW_INF / 2) di[j] = FW_INF;
+				}
+				if (di[i] < 0) ok = false;
+			}
+			return ok;
+		}
+
+#if __cplusplus >= 201103L
+		static int fw_threads(int nthreads) {
+			return nthreads > 0 ? nthreads : (int)std::max(1u, std::thread::hardware_concurrency());
+		}
+#endif
+	}
+
+	/**
+	 * the weight matrix of g: d[u][v] the lightest edge u->v, d[u][u] = 0
+	 * (or a negative self loop), FW_INF elsewhere
+	 */
+	static void adjacency_matrix(const CSRGraph & g, Array2D<int32_t> & d) {
+		uint32_t n = g.vertex_count();
+		if (d.row() != n || d.col() != n) throw std::invalid_argument("matrix size");
+		d.clear(FW_INF);
+		for (uint32_t u = 0; u < n; u++) {
+			d(u, u) = 0;
+			for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+				d(u, g.target(e)) = std::min(d(u, g.target(e)), g.weight(e));
+			}
+		}
+	}
+
+	/**
+	 * all pairs shortest paths in place: d holds the weights, as
+	 * adjacency_matrix() fills it, and gets the distances. returns false
+	 * on a negative cycle, as soon as a round finds one on its diagonal
+	 * block; the matrix is then meaningless.
+	 */
+	static bool floyd_warshall(Array2D<int32_t> & d, int nthreads = 0) {
+		if (d.row() != d.col()) throw std::invalid_argument("matrix not square");
+		uint32_t n = d.row(), nb = (n + detail::FW_BLOCK - 1) / detail::FW_BLOCK;
+#if __cplusplus >= 201103L
+		nthreads = std::min<int>(detail::fw_threads(nthreads), std::max(1u, nb));
+		if (nthreads > 1) {
+			detail::BFBarrier barrier(nthreads);
+			std::vector<std::thread> workers;
+			auto work = [&](int t) {
+				for (uint32_t kb = 0; kb < nb; kb++) {
+					for (int phase = 0; phase < 3; phase++) {
+						detail::fw_phase(d, kb, phase, t, nthreads);
+						barrier.wait();
+						// every thread sees the same diagonal, they all stop
+						if (phase == 0 && detail::fw_negative(d, kb)) return;
+					}
+				}
+			};
+			for (int t = 1; t < nthreads; t++) workers.push_back(std::thread(work, t));
+			work(0);
+			for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+			return detail::fw_finish(d);
+		}
+#else
+		(void)nthreads;
+#endif
+		for (uint32_t kb = 0; kb < nb; kb++) {
+			for (int phase = 0; phase < 3; phase++) {
+				detail::fw_phase(d, kb, phase, 0, 1);
+				if (phase == 0 && detail::fw_negative(d, kb)) return false;
+			}
+		}
+		return detail::fw_finish(d);
+	}
+
+	/**
+	 * all pairs shortest paths of a sparse graph into d (V x V) by Johnson's
+	 * algorithm. returns false on a negative cycle, d is then untouched.
+	 */
+	static bool johnson(const CSRGraph & g, Array2D<int32_t> & d, int nthreads = 0) {
+		uint32_t n = g.vertex_count();
+		if (d.row() != n || d.col() != n) throw std::invalid_argument("matrix size");
+
+		// potentials, only needed with negative weights
+		CSRGraph rg = g;
+		std::vector<int64_t> h(n, 0);
+		bool negative = false;
+		for (uint32_t e = 0; e < g.edge_count(); e++) negative = negative || g.weight(e) < 0;
+		if (negative) {
+			SPFA sp(g);
+			if (!sp.run_all()) return false;
+			h = sp.distances();
+			for (uint32_t u = 0; u < n; u++) {
+				for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+					rg.set_weight(e, (int32_t)(g.weight(e) + h[u] - h[g.target(e)]));
+				}
+			}
+		}
+
+#if __cplusplus >= 201103L
+		nthreads = std::min<int>(detail::fw_threads(nthreads), std::max(1u, n));
+		if (nthreads > 1) {
+			std::atomic<uint32_t> next(0);
+			std::vector<std::thread> workers;
+			auto work = [&]() {
+				std::vector<int64_t> dist;
+				for (uint32_t s; (s = next.fetch_add(1, std::memory_order_relaxed)) < n;) {
+					Dijkstra::run(rg, s, dist);
+					int32_t * ds = d[s];
+					for (uint32_t t = 0; t < n; t++) {
+						ds[t] = dist[t] == DIJKSTRA_INF ? FW_INF : (int32_t)(dist[t] - h[s] + h[t]);
+					}
+				}
+			};
+			for (int t = 1; t < nthreads; t++) workers.push_back(std::thread(work));
+			work();
+			for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+			return true;
+		}
+#else
+		(void)nthreads;
+#endif
+		std::vector<int64_t> dist;
+		for (uint32_t s = 0; s < n; s++) {
+			Dijkstra::run(rg, s, dist);
+			int32_t * ds = d[s];
+			for (uint32_t t = 0; t < n; t++) {
+				ds[t] = dist[t] == DIJKSTRA_INF ? FW_INF : (int32_t)(dist[t] - h[s] + h[t]);
+			}
+		}
+		return true;
+	}
+}
+
+#endif //
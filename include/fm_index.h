@@ -0,0 +1,540 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * FM-INDEX
+ *
+ * Features:
+ * 1. a full-text index of a byte string that replaces the text: the
+ *    Burrows-Wheeler transform of text$ in a Huffman shaped wavelet tree,
+ *    n * H0 bits + 3% for the rank counters; no suffix array & no
+ *    text is kept.
+ * 2. count(P): the number of occurrences by backward search, O(|P| H0)
+ *    rank queries, each O(1) over a bit vector.
+ * 3. locate(P): the positions, from a suffix array sample at every
+ *    rate-th text position: at most rate LF steps per occurrence.
+ * 4. built from the suffix array (SA-IS), which is freed afterwards;
+ *    save / load to a binary file.
+ *
+ * Memory: about n * (H0 + 1) * 1.03 bits + 32 bits per rate characters. The
+ * suffix array costs 4 bytes a character while it is built (8 beyond 4GB).
+ *
+ * http://en.wikipedia.org/wiki/FM-index
+ * Ferragina & Manzini, Opportunistic Data Structures with Applications, 2000
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_FM_INDEX_H__
+#define ALGO_FM_INDEX_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+#include "suffix_array.h"
+
+namespace alg {
+	namespace detail {
+		static inline uint32_t popcount64(uint64_t x) {
+#if defined(__GNUC__)
+			return (uint32_t)__builtin_popcountll(x);
+#else
+			x = x - ((x >> 1) & 0x5555555555555555ULL);
+			x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+			x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+			return (uint32_t)((x * 0x0101010101010101ULL) >> 56);
+#endif
+		}
+
+		/**
+		 * a bit vector with rank in O(1): the ones before every superblock
+		 * of 2^16 bits, before every block of 512 bits within it (16 bits),
+		 * then the popcount of at most 8 words. 3% over the bits.
+		 */
+		class RankBits {
+			private:
+				uint64_t m_n;
+				std::vector<uint64_t> m_words;
+				std::vector<uint64_t> m_super;		// ones before superblock s
+				std::vector<uint16_t> m_blocks;		// ones before block b, in its superblock
+
+			public:
+				RankBits() : m_n(0), m_super(1, 0), m_blocks(1, 0) {}
+
+				void resize(uint64_t n) {
+					m_n = n;
+					m_words.assign((n + 63) / 64, 0);
+				}
+				uint64_t size() const { return m_n; }
+				inline void set(uint64_t i) { m_words[i >> 6] |= 1ULL << (i & 63); }
+				inline bool get(uint64_t i) const { return (m_words[i >> 6] >> (i & 63)) & 1; }
+
+				/**
+				 * the counters, after the last set()
+				 */
+				void build() {
+					uint64_t nb = m_words.size() / 8 + 1;
+					m_blocks.assign(nb, 0);
+					m_super.assign(nb / 128 + 1, 0);
+					uint64_t ones = 0;
+					for (uint64_t b = 0; b < nb; b++) {
+						if (b % 128 == 0) m_super[b / 128] = ones;
+						m_blocks[b] = (uint16_t)(ones - m_super[b / 128]);
+						for (uint64_t w = b * 8; w < b * 8 + 8 && w < m_words.size(); w++) ones += popcount64(m_words[w]);
+					}
+				}
+
+				/**
+				 * the ones in [0, i)
+				 */
+				inline uint64_t rank1(uint64_t i) const {
+					uint64_t w = i >> 6, r = m_super[i >> 16] + m_blocks[i >> 9];
+					for (uint64_t k = w & ~(uint64_t)7; k < w; k++) r += popcount64(m_words[k]);
+					if (i & 63) r += popcount64(m_words[w] & ((1ULL << (i & 63)) - 1));
+					return r;
+				}
+
+				size_t bytes() const {
+					return (m_words.size() + m_super.size()) * sizeof(uint64_t) + m_blocks.size() * sizeof(uint16_t);
+				}
+
+				bool save(FILE * fp) const {
+					uint64_t nw = m_words.size();
+					return fwrite(&m_n, sizeof(m_n), 1, fp) == 1 &&
+						(nw == 0 || fwrite(&m_words[0], sizeof(uint64_t), nw, fp) == nw);
+				}
+
+				/**
+				 * read bits saved by save(), false unless there are n of them.
+				 * the words come a chunk at a time, the memory grows with
+				 * what the file really holds.
+				 */
+				bool load(FILE * fp, uint64_t n) {
+					const uint64_t CHUNK = 1 << 16;
+					uint64_t len;
+					if (fread(&len, sizeof(len), 1, fp) != 1 || len != n || n > ((uint64_t)1 << 58)) return false;
+					uint64_t nw = (n + 63) / 64;
+					m_n = n;
+					m_words.clear();
+					while (m_words.size() < nw) {
+						size_t at = m_words.size(), k = (size_t)std::min(CHUNK, nw - at);
+						m_words.resize(at + k);
+						if (fread(&m_words[at], sizeof(uint64_t), k, fp) != k) return false;
+					}
+					build();
+					return true;
+				}
+		};
+	}
+
+	class FMIndex {
+		private:
+			enum {
+				MAGIC = 0x58494d46,			// "FMIX"
+				VERSION = 1,
+				DOLLAR = 0,					// the symbol of the end marker
+				NSYM = 257,					// $ & the bytes
+				LEAF = 0x80000000			// a child that is the leaf of a symbol
+			};
+			static const uint16_t ABSENT = 0xffff;
+
+			/**
+			 * an internal node of the wavelet tree: its bits are
+			 * [off, off + size) of m_bits, which has `ones` ones before off.
+			 */
+			struct Node {
+				uint64_t off;
+				uint64_t ones;
+				uint32_t child[2];
+			};
+
+			uint64_t m_n;							// the text length, n + 1 rows
+			uint32_t m_rate;
+			uint16_t m_sym[256];					// byte -> symbol, ABSENT if not in the text
+			std::vector<uint64_t> m_C;				// rows of the symbols below s
+			std::vector<Node> m_nodes;				// m_nodes[0] the root
+			std::vector<std::vector<uint8_t> > m_code;	// the path of a symbol from the root
+			detail::RankBits m_bits;				// all the nodes, one after the other
+			detail::RankBits m_sampled;				// rows of a sampled text position
+			std::vector<uint32_t> m_samples;		// position / rate, by row
+
+		public:
+			FMIndex() : m_n(0), m_rate(1) { init(); }
+
+			/**
+			 * index the bytes text[0..n), a position sampled every
+			 * sample_rate characters
+			 */
+			FMIndex(const unsigned char * text, uint64_t n, uint32_t sample_rate = 32) : m_n(n), m_rate(sample_rate) {
+				create(text);
+			}
+
+			explicit FMIndex(const std::string & text, uint32_t sample_rate = 32) : m_n(text.size()), m_rate(sample_rate) {
+				create((const unsigned char *)text.data());
+			}
+
+			/**
+			 * the length of the text
+			 */
+			uint64_t size() const { return m_n; }
+
+			/**
+			 * the memory of the index, in bytes
+			 */
+			size_t bytes() const {
+				return m_bits.bytes() + m_sampled.bytes() + m_samples.size() * sizeof(uint32_t) +
+					m_nodes.size() * sizeof(Node) + m_C.size() * sizeof(uint64_t);
+			}
+
+			/**
+			 * the number of occurrences of p[0..m) in the text, 0 for an
+			 * empty pattern
+			 */
+			uint64_t count(const unsigned char * p, size_t m) const {
+				uint64_t sp, ep;
+				return range(p, m, sp, ep) ? ep - sp : 0;
+			}
+			uint64_t count(const std::string & p) const { return count((const unsigned char *)p.data(), p.size()); }
+
+			/**
+			 * the positions of p[0..m) in the text, ascending. throws
+			 * std::runtime_error on a loaded index that turns out corrupt.
+			 */
+			void locate(const unsigned char * p, size_t m, std::vector<uint64_t> & pos) const {
+				pos.clear();
+				uint64_t sp, ep;
+				if (!range(p, m, sp, ep)) return;
+				pos.reserve(ep - sp);
+				for (uint64_t r = sp; r < ep; r++) pos.push_back(position(r));
+				std::sort(pos.begin(), pos.end());
+			}
+			void locate(const std::string & p, std::vector<uint64_t> & pos) const {
+				locate((const unsigned char *)p.data(), p.size(), pos);
+			}
+
+			/**
+			 * write the index, returns false on an I/O error
+			 */
+			bool save(FILE * fp) const {
+				uint32_t hdr[4] = {MAGIC, VERSION, m_rate, (uint32_t)m_nodes.size()};
+				if (fwrite(hdr, sizeof(hdr), 1, fp) != 1 || fwrite(&m_n, sizeof(m_n), 1, fp) != 1 ||
+						fwrite(m_sym, sizeof(m_sym), 1, fp) != 1 || fwrite(&m_C[0], sizeof(uint64_t), NSYM + 1, fp) != (size_t)NSYM + 1) {
+					return false;
+				}
+				for (size_t i = 0; i < m_nodes.size(); i++) {
+					if (fwrite(&m_nodes[i].off, sizeof(uint64_t), 1, fp) != 1 ||
+							fwrite(m_nodes[i].child, sizeof(uint32_t), 2, fp) != 2) return false;
+				}
+				uint64_t ns = m_samples.size();
+				return m_bits.save(fp) && m_sampled.save(fp) && fwrite(&ns, sizeof(ns), 1, fp) == 1 &&
+					(ns == 0 || fwrite(&m_samples[0], sizeof(uint32_t), ns, fp) == ns);
+			}
+
+			/**
+			 * read an index, returns false if it is short or not an index
+			 */
+			bool load(FILE * fp) {
+				uint32_t hdr[4];
+				FMIndex x;
+				if (fread(hdr, sizeof(hdr), 1, fp) != 1 || hdr[0] != MAGIC || hdr[1] != VERSION ||
+						hdr[2] == 0 || hdr[3] >= NSYM) return false;
+				x.m_rate = hdr[2];
+				x.m_nodes.resize(hdr[3]);
+				if (fread(&x.m_n, sizeof(x.m_n), 1, fp) != 1 || fread(x.m_sym, sizeof(x.m_sym), 1, fp) != 1 ||
+						fread(&x.m_C[0], sizeof(uint64_t), NSYM + 1, fp) != (size_t)NSYM + 1) return false;
+				for (size_t i = 0; i < x.m_nodes.size(); i++) {
+					if (fread(&x.m_nodes[i].off, sizeof(uint64_t), 1, fp) != 1 ||
+							fread(x.m_nodes[i].child, sizeof(uint32_t), 2, fp) != 2) return false;
+				}
+				// the header tells the length of every part, checked before
+				// they are read
+				uint64_t ns, nbits;
+				std::vector<uint64_t> rows;
+				if (!x.valid(nbits, rows)) return false;
+				if (!x.m_bits.load(fp, nbits) || !x.valid_bits(rows) || !x.m_sampled.load(fp, x.m_n + 1) ||
+						fread(&ns, sizeof(ns), 1, fp) != 1 || ns != x.m_sampled.rank1(x.m_sampled.size())) return false;
+				x.m_samples.resize(ns);
+				if (ns != 0 && fread(&x.m_samples[0], sizeof(uint32_t), ns, fp) != ns) return false;
+				x.finish();
+				swap(x);
+				return true;
+			}
+
+		private:
+			void create(const unsigned char * text) {
+				if (m_rate == 0) throw std::invalid_argument("sample rate 0");
+				if (m_n / m_rate >= UINT32_MAX) throw std::length_error("text too long for the sample rate");
+				init();
+				if (m_n < UINT32_MAX) build<uint32_t>(text);
+				else build<uint64_t>(text);
+			}
+
+			void init() {
+				for (int b = 0; b < 256; b++) m_sym[b] = ABSENT;
+				m_C.assign(NSYM + 1, 0);
+			}
+
+			void swap(FMIndex & o) {
+				std::swap(m_n, o.m_n);
+				std::swap(m_rate, o.m_rate);
+				for (int b = 0; b < 256; b++) std::swap(m_sym[b], o.m_sym[b]);
+				m_C.swap(o.m_C);
+				m_nodes.swap(o.m_nodes);
+				m_code.swap(o.m_code);
+				std::swap(m_bits, o.m_bits);
+				std::swap(m_sampled, o.m_sampled);
+				m_samples.swap(o.m_samples);
+			}
+
+			template<typename IndexT>
+			void build(const unsigned char * text) {
+				if (m_n == 0) {
+					// the row of $ alone
+					for (uint32_t c = DOLLAR; c < NSYM; c++) m_C[c + 1] = 1;
+					m_sampled.resize(1);
+					m_sampled.set(0);
+					m_sampled.build();
+					m_samples.push_back(0);
+					return;
+				}
+				IndexT n = (IndexT)m_n;
+				std::vector<IndexT> sa(n);
+				sais(text, n, &sa[0]);
+
+				// the symbols: $, then the bytes of the text in order
+				std::vector<uint64_t> freq(NSYM, 0);
+				freq[DOLLAR] = 1;
+				std::vector<uint64_t> byte_freq(256, 0);
+				for (IndexT i = 0; i < n; i++) byte_freq[text[i]]++;
+				uint16_t s = 1;
+				for (int b = 0; b < 256; b++) {
+					if (byte_freq[b]) {
+						m_sym[b] = s;
+						freq[s++] = byte_freq[b];
+					}
+				}
+				for (uint32_t c = 0; c < NSYM; c++) m_C[c + 1] = m_C[c] + freq[c];
+				huffman(freq);
+				codes();
+
+				// the bits of every row down its path, node by node in row order
+				std::vector<uint64_t> fill(m_nodes.size());
+				for (size_t k = 0; k < m_nodes.size(); k++) fill[k] = m_nodes[k].off;
+				m_sampled.resize(m_n + 1);
+				for (uint64_t r = 0; r <= m_n; r++) {
+					// row 0 is the suffix $, then the suffixes in order
+					uint64_t p = r == 0 ? m_n : sa[r - 1];
+					uint32_t c = p == 0 ? (uint32_t)DOLLAR : m_sym[text[p - 1]];
+					uint32_t node = 0;
+					const std::vector<uint8_t> & code = m_code[c];
+					for (size_t k = 0; k < code.size(); k++) {
+						if (code[k]) m_bits.set(fill[node]);
+						fill[node]++;
+						node = m_nodes[node].child[code[k]];
+					}
+					if (p % m_rate == 0) {
+						m_sampled.set(r);
+						m_samples.push_back((uint32_t)(p / m_rate));
+					}
+				}
+				m_sampled.build();
+				finish();
+			}
+
+			/**
+			 * the wavelet tree of a Huffman code for the symbol frequencies,
+			 * the bits of the nodes laid out in m_bits
+			 */
+			void huffman(const std::vector<uint64_t> & freq) {
+				// (weight, child) of the trees left to merge
+				std::vector<std::pair<uint64_t, uint32_t> > trees;
+				for (uint32_t c = 0; c < NSYM; c++) {
+					if (freq[c]) trees.push_back(std::make_pair(freq[c], (uint32_t)LEAF | c));
+				}
+				std::vector<Node> nodes;
+				std::vector<uint64_t> weight;
+				while (trees.size() > 1) {
+					std::sort(trees.begin(), trees.end());
+					Node x;
+					x.off = x.ones = 0;
+					x.child[0] = trees[0].second;
+					x.child[1] = trees[1].second;
+					nodes.push_back(x);
+					weight.push_back(trees[0].first + trees[1].first);
+					trees.erase(trees.begin(), trees.begin() + 2);
+					trees.push_back(std::make_pair(weight.back(), (uint32_t)nodes.size() - 1));
+				}
+				// the root first: renumber in reverse creation order
+				uint32_t k = (uint32_t)nodes.size();
+				m_nodes.resize(k);
+				uint64_t off = 0;
+				for (uint32_t i = 0; i < k; i++) {
+					Node x = nodes[k - 1 - i];
+					for (int b = 0; b < 2; b++) {
+						if (!(x.child[b] & LEAF)) x.child[b] = k - 1 - x.child[b];
+					}
+					x.off = off;
+					off += weight[k - 1 - i];
+					m_nodes[i] = x;
+				}
+				m_bits.resize(off);
+			}
+
+			/**
+			 * the node counters, once the bits are set
+			 */
+			void finish() {
+				m_bits.build();
+				for (size_t i = 0; i < m_nodes.size(); i++) m_nodes[i].ones = m_bits.rank1(m_nodes[i].off);
+				codes();
+			}
+
+			/**
+			 * the path of every symbol, from the tree
+			 */
+			void codes() {
+				m_code.assign(NSYM, std::vector<uint8_t>());
+				if (m_nodes.empty()) return;
+				std::vector<std::pair<uint32_t, std::vector<uint8_t> > > stack;
+				stack.push_back(std::make_pair(0u, std::vector<uint8_t>()));
+				while (!stack.empty()) {
+					uint32_t node = stack.back().first;
+					std::vector<uint8_t> path = stack.back().second;
+					stack.pop_back();
+					for (uint8_t b = 0; b < 2; b++) {
+						uint32_t c = m_nodes[node].child[b];
+						path.push_back(b);
+						if (c & LEAF) m_code[c & ~(uint32_t)LEAF] = path;
+						else stack.push_back(std::make_pair(c, path));
+						path.pop_back();
+					}
+				}
+			}
+
+			/**
+			 * the header of a loaded index: counts & symbols in order,
+			 * children after their parent, the bits of every node in range.
+			 * nbits: the length of the bits of all the nodes, rows: of
+			 * every node.
+			 */
+			bool valid(uint64_t & nbits, std::vector<uint64_t> & rows) const {
+				nbits = 0;
+				if (m_n >= ((uint64_t)1 << 58) || m_C[0] != 0 || m_C[NSYM] != m_n + 1) return false;
+				for (uint32_t c = 0; c < NSYM; c++) {
+					if (m_C[c] > m_C[c + 1]) return false;
+				}
+				for (int b = 0; b < 256; b++) {
+					if (m_sym[b] != ABSENT && (m_sym[b] == DOLLAR || m_sym[b] >= NSYM)) return false;
+				}
+				if (m_n == 0) return m_nodes.empty();
+				if (m_nodes.empty()) return false;
+				// the rows of a node: the sum of its leaves, children first
+				rows.assign(m_nodes.size(), 0);
+				for (size_t i = m_nodes.size(); i-- > 0;) {
+					for (int b = 0; b < 2; b++) {
+						uint32_t c = m_nodes[i].child[b];
+						if (c & LEAF) {
+							c &= ~(uint32_t)LEAF;
+							if (c >= NSYM) return false;
+							rows[i] += m_C[c + 1] - m_C[c];
+						} else {
+							if (c <= i || c >= m_nodes.size()) return false;
+							rows[i] += rows[c];
+						}
+					}
+					if (rows[i] > m_n + 1) return false;
+					nbits += rows[i];
+					if (nbits > ((uint64_t)1 << 58)) return false;
+				}
+				for (size_t i = 0; i < m_nodes.size(); i++) {
+					if (m_nodes[i].off > nbits || rows[i] > nbits - m_nodes[i].off) return false;
+				}
+				return rows[0] == m_n + 1;
+			}
+
+			/**
+			 * the ones of every node are the rows of its right child: a
+			 * rank never leads out of the node below
+			 */
+			bool valid_bits(const std::vector<uint64_t> & rows) const {
+				for (size_t i = 0; i < m_nodes.size(); i++) {
+					uint32_t c = m_nodes[i].child[1];
+					uint64_t right = c & LEAF ? m_C[(c & ~(uint32_t)LEAF) + 1] - m_C[c & ~(uint32_t)LEAF] : rows[c];
+					if (m_bits.rank1(m_nodes[i].off + rows[i]) - m_bits.rank1(m_nodes[i].off) != right) return false;
+				}
+				return true;
+			}
+
+			/**
+			 * the occurrences of c in the rows [0, i)
+			 */
+			inline uint64_t rank(uint32_t c, uint64_t i) const {
+				const std::vector<uint8_t> & code = m_code[c];
+				uint32_t node = 0;
+				for (size_t k = 0; k < code.size(); k++) {
+					const Node & x = m_nodes[node];
+					uint64_t ones = m_bits.rank1(x.off + i) - x.ones;
+					i = code[k] ? ones : i - ones;
+					node = x.child[code[k]];
+				}
+				return i;
+			}
+
+			/**
+			 * LF(r): the row of the suffix one position earlier
+			 */
+			inline uint64_t lf(uint64_t r, uint32_t & c) const {
+				uint32_t node = 0;
+				for (;;) {
+					const Node & x = m_nodes[node];
+					uint32_t b = m_bits.get(x.off + r);
+					uint64_t ones = m_bits.rank1(x.off + r) - x.ones;
+					r = b ? ones : r - ones;
+					node = x.child[b];
+					if (node & LEAF) break;
+				}
+				c = node & ~(uint32_t)LEAF;
+				return m_C[c] + r;
+			}
+
+			/**
+			 * the rows [sp, ep) of the suffixes starting with p
+			 */
+			bool range(const unsigned char * p, size_t m, uint64_t & sp, uint64_t & ep) const {
+				if (m == 0 || m_n == 0) return false;
+				sp = 0;
+				ep = m_n + 1;
+				for (size_t k = m; k-- > 0;) {
+					uint32_t c = m_sym[p[k]];
+					if (c == ABSENT) return false;
+					sp = m_C[c] + rank(c, sp);
+					ep = m_C[c] + rank(c, ep);
+					if (sp >= ep) return false;
+				}
+				return true;
+			}
+
+			/**
+			 * the text position of row r, by LF steps to a sampled row,
+			 * fewer than the sample rate unless a loaded index is corrupt
+			 */
+			uint64_t position(uint64_t r) const {
+				uint64_t steps = 0;
+				uint32_t c;
+				while (!m_sampled.get(r)) {
+					if (steps == m_rate) throw std::runtime_error("corrupt index");
+					r = lf(r, c);
+					steps++;
+				}
+				return (uint64_t)m_samples[m_sampled.rank1(r)] * m_rate + steps;
+			}
+	};
+}
+
+#endif //
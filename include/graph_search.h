@@ -26,6 +26,8 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <limits.h>
+#include <vector>
+#include <utility>
 
 #include "queue.h"
 #include "stack.h"
@@ -92,23 +94,38 @@ namespace alg {
 	}
 
 	/**
-	 * recursivly visit (Call Stack)
+	 * visit with an explicit stack instead of recursion, so that long paths
+	 * do not overflow the call stack
 	 */
 	static void _DFS_VISIT(Graph &g, Graph::Adjacent * u) {
+		// (vertex, its last explored edge)
+		std::vector<std::pair<Graph::Adjacent *, struct list_head *> > S;
+
 		// white vertex u has just benn discovered
 		u->d = ++g.graph_tick;
 		u->color = Graph::GRAY;
+		S.push_back(std::make_pair(u, &u->v_head));
 
-		Graph::Vertex * _v;
-		list_for_each_entry(_v, &u->v_head, v_node) { // explore edge (u, v)
-			Graph::Adjacent * v = g[_v->id];	// retrive the original adjacent list
-			if (v->color == Graph::WHITE) {
-				_DFS_VISIT(g, v);
+		while (!S.empty()) {
+			Graph::Adjacent * a = S.back().first;
+			struct list_head * pos = S.back().second->next;
+			if (pos != &a->v_head) {	// explore edge (a, v)
+				S.back().second = pos;
+				Graph::Vertex * _v = list_entry(pos, Graph::Vertex, v_node);
+				Graph::Adjacent * v = g[_v->id];	// retrive the original adjacent list
+				if (v->color == Graph::WHITE) {
+					v->d = ++g.graph_tick;
+					v->color = Graph::GRAY;
+					S.push_back(std::make_pair(v, &v->v_head));
+				}
+				continue;
 			}
+
+			S.pop_back();
+			a->color = Graph::BLACK;
+			a->f = ++g.graph_tick;
+			printf("%d(d:%d, f:%d) -> ", a->v.id, a->d, a->f);
 		}
-		u->color = Graph::BLACK;
-		u->f = ++g.graph_tick;
-		printf("%d(d:%d, f:%d) -> ", u->v.id, u->d, u->f);
 	}
 }
 
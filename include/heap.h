@@ -25,6 +25,10 @@
  * 2. Pop – Delete and return the smallest item in the heap.
  * 3. Remove - Remove an element
  *
+ * IndexedHeap is a d-ary min-heap over the items 0..n-1 with a position
+ * table, for O(log_d n) decrease-key in Dijkstra & Prim alike. A 4-ary heap
+ * is shallower than a binary one and its children share a cache line.
+ *
  * http://en.wikipedia.org/wiki/Binary_heap
  ******************************************************************************/
 
@@ -36,6 +40,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <vector>
 #include "generic.h"
 
 namespace alg { 
@@ -190,6 +195,118 @@ namespace alg {
 					return m_heap[i].key < m_heap[j].key;
 				}
 		};
+
+	/**
+	 * indexed d-ary min-heap, every item 0..n-1 is in the heap at most once.
+	 */
+	template<typename KeyT, int D = 4>
+		class IndexedHeap {
+			public:
+				static const uint32_t NPOS = UINT32_MAX;
+
+			private:
+				std::vector<uint32_t> m_heap;	// items, heap ordered by key
+				std::vector<uint32_t> m_pos;	// position of an item in m_heap, or NPOS
+				std::vector<KeyT> m_key;		// key of an item
+
+			public:
+				explicit IndexedHeap(uint32_t n) : m_pos(n, NPOS), m_key(n) {
+					m_heap.reserve(n);
+				}
+
+				inline uint32_t count() const { return (uint32_t)m_heap.size(); }
+				inline bool is_empty() const { return m_heap.empty(); }
+				inline bool contains(uint32_t item) const { return m_pos[item] != NPOS; }
+				inline const KeyT & key(uint32_t item) const { return m_key[item]; }
+
+				/**
+				 * the item with the min key
+				 */
+				inline uint32_t top() const { return m_heap[0]; }
+
+				/**
+				 * insert an item, or change the key of a contained one
+				 */
+				void push(uint32_t item, const KeyT & key) {
+					if (contains(item)) {
+						bool dec = key < m_key[item];
+						m_key[item] = key;
+						if (dec) up(m_pos[item]);
+						else down(m_pos[item]);
+						return;
+					}
+					m_key[item] = key;
+					m_pos[item] = (uint32_t)m_heap.size();
+					m_heap.push_back(item);
+					up(m_pos[item]);
+				}
+
+				/**
+				 * lower the key of a contained item
+				 */
+				void decrease_key(uint32_t item, const KeyT & key) {
+					m_key[item] = key;
+					up(m_pos[item]);
+				}
+
+				/**
+				 * remove & return the item with the min key
+				 */
+				uint32_t pop() {
+					uint32_t item = m_heap[0];
+					uint32_t last = m_heap.back();
+					m_heap.pop_back();
+					m_pos[item] = NPOS;
+					if (!m_heap.empty()) {
+						m_heap[0] = last;
+						m_pos[last] = 0;
+						down(0);
+					}
+					return item;
+				}
+
+				void clear() {
+					for (uint32_t i = 0; i < m_heap.size(); i++) m_pos[m_heap[i]] = NPOS;
+					m_heap.clear();
+				}
+
+			private:
+				void up(uint32_t i) {
+					uint32_t item = m_heap[i];
+					while (i > 0) {
+						uint32_t p = (i - 1) / D;
+						if (!(m_key[item] < m_key[m_heap[p]])) break;
+						m_heap[i] = m_heap[p];
+						m_pos[m_heap[i]] = i;
+						i = p;
+					}
+					m_heap[i] = item;
+					m_pos[item] = i;
+				}
+
+				void down(uint32_t i) {
+					uint32_t item = m_heap[i];
+					uint32_t n = (uint32_t)m_heap.size();
+					for (;;) {
+						uint32_t c = D * i + 1;		// first child
+						if (c >= n) break;
+						uint32_t end = c + D < n ? c + D : n;
+						uint32_t best = c;
+						for (uint32_t j = c + 1; j < end; j++) {
+							if (m_key[m_heap[j]] < m_key[m_heap[best]]) best = j;
+						}
+						if (!(m_key[m_heap[best]] < m_key[item])) break;
+						m_heap[i] = m_heap[best];
+						m_pos[m_heap[i]] = i;
+						i = best;
+					}
+					m_heap[i] = item;
+					m_pos[item] = i;
+				}
+		};
+
+	template<typename KeyT, int D>
+		const uint32_t IndexedHeap<KeyT, D>::NPOS;
 }
 
 #endif //
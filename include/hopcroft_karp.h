@@ -0,0 +1,183 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * HOPCROFT-KARP MAXIMUM BIPARTITE MATCHING
+ *
+ * Features:
+ * 1. maximum cardinality matching between a left & a right vertex set in
+ *    O(E sqrt(V))
+ * 2. each phase finds the shortest augmenting paths by a BFS from all the
+ *    free left vertices, then augments a maximal set of vertex disjoint ones
+ *    by DFS along the BFS layers
+ * 3. the edges are kept in adjacency arrays (CSR), the DFS is iterative
+ * 4. the matching itself is returned, mate of every vertex on both sides
+ *
+ * For a weighted assignment use MinCostFlow in max_flow.h.
+ *
+ * http://en.wikipedia.org/wiki/Hopcroft%E2%80%93Karp_algorithm
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_HOPCROFT_KARP_H__
+#define ALGO_HOPCROFT_KARP_H__
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace alg {
+	class HopcroftKarp {
+		public:
+			static const uint32_t NONE = UINT32_MAX;
+
+		private:
+			uint32_t m_nl, m_nr;
+			std::vector<std::pair<uint32_t, uint32_t> > m_edges;
+			bool m_built;
+			std::vector<uint32_t> m_offset;		// right neighbours of l: [m_offset[l], m_offset[l+1])
+			std::vector<uint32_t> m_adj;
+
+			std::vector<uint32_t> m_mate_l;		// left -> right, or NONE
+			std::vector<uint32_t> m_mate_r;		// right -> left, or NONE
+			std::vector<uint32_t> m_dist;		// BFS layer of a left vertex
+			std::vector<uint32_t> m_cur;		// current edge of a left vertex
+			std::vector<uint32_t> m_queue;
+			std::vector<uint32_t> m_stack;
+
+		public:
+			HopcroftKarp(uint32_t nleft, uint32_t nright) :
+				m_nl(nleft), m_nr(nright), m_built(false),
+				m_mate_l(nleft, (uint32_t)NONE), m_mate_r(nright, (uint32_t)NONE) {}
+
+			/**
+			 * an edge between the left vertex l & the right vertex r
+			 */
+			void add_edge(uint32_t l, uint32_t r) {
+				if (l >= m_nl || r >= m_nr) throw std::out_of_range("vertex out of range");
+				m_edges.push_back(std::make_pair(l, r));
+				m_built = false;
+			}
+
+			/**
+			 * compute a maximum matching, returns its size.
+			 * the current matching is the starting point, so edges added
+			 * after a run only cost the extra augmentations.
+			 */
+			uint32_t run() {
+				build();
+				m_dist.resize(m_nl);
+				m_cur.resize(m_nl);
+				while (bfs()) {
+					for (uint32_t l = 0; l < m_nl; l++) m_cur[l] = m_offset[l];
+					for (uint32_t l = 0; l < m_nl; l++) {
+						if (m_mate_l[l] == NONE) dfs(l);
+					}
+				}
+				return size();
+			}
+
+			uint32_t size() const {
+				uint32_t k = 0;
+				for (uint32_t l = 0; l < m_nl; l++) k += m_mate_l[l] != NONE;
+				return k;
+			}
+
+			/**
+			 * the right vertex matched with l, or NONE
+			 */
+			inline uint32_t mate_left(uint32_t l) const { return m_mate_l[l]; }
+			/**
+			 * the left vertex matched with r, or NONE
+			 */
+			inline uint32_t mate_right(uint32_t r) const { return m_mate_r[r]; }
+
+		private:
+			void build() {
+				if (m_built) return;
+				m_offset.assign(m_nl + 1, 0);
+				for (size_t i = 0; i < m_edges.size(); i++) m_offset[m_edges[i].first + 1]++;
+				for (uint32_t l = 0; l < m_nl; l++) m_offset[l + 1] += m_offset[l];
+				m_adj.resize(m_edges.size());
+				std::vector<uint32_t> pos(m_offset.begin(), m_offset.end() - 1);
+				for (size_t i = 0; i < m_edges.size(); i++) m_adj[pos[m_edges[i].first]++] = m_edges[i].second;
+				m_built = true;
+			}
+
+			/**
+			 * layer the left vertices by alternating paths from the free
+			 * ones, returns whether a free right vertex is reachable.
+			 */
+			bool bfs() {
+				m_queue.clear();
+				for (uint32_t l = 0; l < m_nl; l++) {
+					if (m_mate_l[l] == NONE) {
+						m_dist[l] = 0;
+						m_queue.push_back(l);
+					} else {
+						m_dist[l] = NONE;
+					}
+				}
+
+				uint32_t limit = NONE;		// layer of the shortest augmenting paths
+				for (size_t i = 0; i < m_queue.size(); i++) {
+					uint32_t l = m_queue[i];
+					if (m_dist[l] >= limit) break;
+					for (uint32_t e = m_offset[l]; e < m_offset[l + 1]; e++) {
+						uint32_t l2 = m_mate_r[m_adj[e]];
+						if (l2 == NONE) {
+							limit = m_dist[l];
+						} else if (m_dist[l2] == NONE) {
+							m_dist[l2] = m_dist[l] + 1;
+							m_queue.push_back(l2);
+						}
+					}
+				}
+				return limit != NONE;
+			}
+
+			/**
+			 * augment along one layered path from the free vertex root,
+			 * iteratively; dead ends are removed from the layers.
+			 */
+			bool dfs(uint32_t root) {
+				m_stack.assign(1, root);
+				while (!m_stack.empty()) {
+					uint32_t l = m_stack.back();
+					uint32_t & e = m_cur[l];
+					bool advanced = false;
+					for (; e < m_offset[l + 1]; e++) {
+						uint32_t r = m_adj[e];
+						uint32_t l2 = m_mate_r[r];
+						if (l2 == NONE) {
+							// flip the path: every l on the stack takes its current r
+							for (size_t i = m_stack.size(); i-- > 0;) {
+								uint32_t x = m_stack[i];
+								uint32_t y = m_adj[m_cur[x]];
+								m_mate_l[x] = y;
+								m_mate_r[y] = x;
+							}
+							return true;
+						}
+						if (m_dist[l2] == m_dist[l] + 1) {
+							m_stack.push_back(l2);
+							advanced = true;
+							break;
+						}
+					}
+					if (advanced) continue;
+
+					m_dist[l] = NONE;		// dead end
+					m_stack.pop_back();
+					if (!m_stack.empty()) m_cur[m_stack.back()]++;
+				}
+				return false;
+			}
+	};
+}
+
+#endif //
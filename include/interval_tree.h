@@ -1,9 +1,9 @@
 /*******************************************************************************
  * DANIEL'S ALGORITHM IMPLEMENTAIONS
  *
- *  /\  |  _   _  ._ o _|_ |_  ._ _   _ 
- * /--\ | (_| (_) |  |  |_ | | | | | _> 
- *         _|                      
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
  *
  * INTERVAL-TREE
  *
@@ -11,7 +11,11 @@
  * 1. red-black tree based
  * 2. O(logn) lookup performance
  * 3. range search [low, high]
- * 
+ * 4. report all k intervals overlapping a point or a range, in
+ *    O(min(n, (k + 1)logn))
+ * 5. any ordered bound type (int64_t, double, timestamps ...) with a payload
+ * 6. StaticIntervalTree: bulk built, array based, for read-heavy use
+ *
  * http://en.wikipedia.org/wiki/Interval_tree
  *
  ******************************************************************************/
@@ -22,25 +26,29 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <limits.h>
+#include <vector>
+#include <algorithm>
+#include <iostream>
 #include "generic.h"
 #include "stack.h"
 #include "double_linked_list.h"
 #include "rbtree.h"
 
 namespace alg {
-	class IntervalTree:public RBTreeAbstract {
+	template<typename BoundT, typename PayloadT = char>
+	class BasicIntervalTree:public RBTreeAbstract {
 		public:
 			/**
 			 * Interval-Tree node definition
 			 */
 			typedef struct ivltree_node_t : public rbtree_node_t {
-				int low;	// lower-bound
-				int high;	// higher-bound
-				int m;		// max subtree upper bound value
+				BoundT low;			// lower-bound
+				BoundT high;		// higher-bound
+				BoundT m;			// max subtree upper bound value
+				PayloadT payload;	// user data
 			} * ivltree_node;
 
 #define IVLNODE(rbnode) static_cast<ivltree_node>(rbnode)
-#define IVLNODE_M(rbnode) (rbnode?IVLNODE(rbnode)->m:INT_MIN)
 
 		public:
 			/**
@@ -48,39 +56,55 @@ namespace alg {
 			 * initialized an interval tree
 			 * same as init an red-black tree
 			 */
-			IntervalTree() { }
+			BasicIntervalTree() { }
 
 			/**
 			 * ivltree_lookup
 			 *
 			 * search range [low, high] for overlap, return only one element
-			 * use lookup & delete & insert schema to get multiple elements
+			 * use overlaps() to get all of the elements.
 			 *
 			 * NULL is returned if not found.
 			 */
-			ivltree_node lookup(int low, int high) {
+			ivltree_node lookup(BoundT low, BoundT high) {
 				ivltree_node n = IVLNODE(get_root());
-				while (n != NULL && (low > n->high || n->low > high)) { // should search in childs
-					if (n->left !=NULL && low <=IVLNODE(n->left)->m) n = IVLNODE(n->left); // path choice on m.
+				while (n != NULL && (n->high < low || high < n->low)) { // should search in childs
+					if (n->left !=NULL && !(IVLNODE(n->left)->m < low)) n = IVLNODE(n->left); // path choice on m.
 					else n = IVLNODE(n->right);
 				}
 
 				return n;
 			}
 
+			/**
+			 * report all k intervals overlapping [low, high], in
+			 * O(min(n, (k + 1)logn)): a subtree is entered only if it holds
+			 * an interval ending at low or later
+			 */
+			void overlaps(BoundT low, BoundT high, std::vector<ivltree_node> & out) {
+				overlaps_helper(IVLNODE(get_root()), low, high, out);
+			}
+
+			/**
+			 * report all intervals containing `point`
+			 */
+			void stab(BoundT point, std::vector<ivltree_node> & out) {
+				overlaps_helper(IVLNODE(get_root()), point, point, out);
+			}
+
 			/**
 			 * ivltree_insert
 			 * insert range [low, high] into red-black tree
 			 */
-			void insert(int low, int high) {
-				ivltree_node inserted_node = new_node(low, high, RED, NULL, NULL);
+			ivltree_node insert(BoundT low, BoundT high, const PayloadT & payload = PayloadT()) {
+				ivltree_node inserted_node = new_node(low, high, payload, RED, NULL, NULL);
 				if (get_root() == NULL) {
 					set_root(inserted_node);
 				} else {
 					ivltree_node n = IVLNODE(get_root());
 					while (1) {
 						// update 'm' for each node traversed from root
-						if (inserted_node->m > n->m) {
+						if (n->m < inserted_node->m) {
 							n->m = inserted_node->m;
 						}
 
@@ -104,6 +128,7 @@ namespace alg {
 					inserted_node->parent = n;
 				}
 				insert_case1(inserted_node);
+				return inserted_node;
 			}
 
 			/**
@@ -118,12 +143,10 @@ namespace alg {
 					ivltree_node pred = IVLNODE(maximum_node(n->left));
 					n->low = pred->low;
 					n->high= pred->high;
+					n->payload = pred->payload;
 					n = pred;
 				}
 
-				// fixup the 'm' value until m is not the max value of the path.
-				fixup_m(n);
-
 				assert(n->left == NULL || n->right == NULL);
 				child = n->right == NULL ? n->left : n->right;
 				if (node_color(n) == BLACK) {
@@ -134,6 +157,8 @@ namespace alg {
 				replace_node(n, child);
 	    		if (n->parent == NULL && child != NULL)	// root
         			child->color = BLACK;
+				// fixup the 'm' value of every ancestor of the removed node
+				fixup_m(n->parent);
 				delete(n);
 			}
 
@@ -155,16 +180,14 @@ namespace alg {
 				}
 				for(i=0; i<indent; i++)
 					fputs(" ", stdout);
-				if (n->color == BLACK)
-					printf("[%d %d, m->%d]\n", n->low,n->high,n->m);
-				else
-					printf("*[%d %d, m->%d]\n", n->low, n->high,n->m);
+				if (n->color != BLACK) std::cout << "*";
+				std::cout << "[" << n->low << " " << n->high << ", m->" << n->m << "]" << std::endl;
 				if (n->left != NULL) {
 					print_helper(IVLNODE(n->left), indent + INDENT_STEP);
 				}
 			}
 
-			~IntervalTree() {
+			~BasicIntervalTree() {
 				destruct(IVLNODE(get_root()));
 			}
 
@@ -176,14 +199,31 @@ namespace alg {
 				delete n;
 			}
 
+			void overlaps_helper(ivltree_node n, const BoundT & low, const BoundT & high, std::vector<ivltree_node> & out) {
+				while (n != NULL && !(n->m < low)) {	// something in this subtree ends at low or later
+					overlaps_helper(IVLNODE(n->left), low, high, out);
+					if (high < n->low) return;			// the right subtree starts even later
+					if (!(n->high < low)) out.push_back(n);
+					n = IVLNODE(n->right);
+				}
+			}
+
+			/**
+			 * recompute 'm' value of a node by it's children.
+			 */
+			void update_m(ivltree_node n) {
+				n->m = n->high;
+				if (n->left != NULL && n->m < IVLNODE(n->left)->m) n->m = IVLNODE(n->left)->m;
+				if (n->right != NULL && n->m < IVLNODE(n->right)->m) n->m = IVLNODE(n->right)->m;
+			}
+
 			/**
 			 * fix 'm' value caused by rotation
 			 */
 			void rotate_left_callback(rbtree_node n, rbtree_node parent) {
-				// parent inherit max m value
-				IVLNODE(parent)->m = IVLNODE(n)->m;
-				// update node 'm' value by it's children.
-				IVLNODE(n)->m = Max(IVLNODE(n)->high, Max(IVLNODE_M(n->left), IVLNODE_M(n->right)));
+				// update node 'm' value by it's children, then the new parent.
+				update_m(IVLNODE(n));
+				update_m(IVLNODE(parent));
 			}
 
 			void rotate_right_callback(rbtree_node n, rbtree_node parent) {
@@ -191,39 +231,23 @@ namespace alg {
 			}
 
 			/**
-			 * fix up 'm' value caued by deletion
+			 * fix up 'm' value caued by deletion, from n up to the root.
 			 */
 			void fixup_m(rbtree_node n) {
-				int m = IVLNODE(n)->m;
-				int m_new = Max(IVLNODE_M(n->left), IVLNODE_M(n->right));
-
-				// if current 'm' is not decided by n->high, just return.
-				if (m==m_new) return;
-
-				while(n->parent !=NULL) {
-					/*
-					   parent(high)
-					   /	      \
-					   n(m_new)	  sibling(m)
-
-					 */	
-					IVLNODE(n->parent)->m = 
-						Max(IVLNODE(n->parent)->high, Max(m_new, IVLNODE_M(sibling(n))));
-
-					if(IVLNODE_M(n->parent) > m) break;	// since node n does not affect
-					//  the result anymore, we break.
-					n = n->parent;
+				for (; n != NULL; n = n->parent) {
+					update_m(IVLNODE(n));
 				}
 			}
 
 			/**
 			 * create a new node, and set default vales.
 			 */
-			ivltree_node new_node(int low, int high, color rbtree_node_color, rbtree_node left, rbtree_node right) {
+			ivltree_node new_node(BoundT low, BoundT high, const PayloadT & payload, color rbtree_node_color, rbtree_node left, rbtree_node right) {
 				ivltree_node result = new ivltree_node_t;
 				result->low = low;
 				result->high = high;
 				result->m = high;
+				result->payload = payload;
 				result->color = rbtree_node_color;
 				result->left = left;
 				result->right = right;
@@ -232,6 +256,102 @@ namespace alg {
 				result->parent = NULL;
 				return result;
 			}
+#undef IVLNODE
+	};
+
+	typedef BasicIntervalTree<int> IntervalTree;
+
+	/**
+	 * Static interval tree.
+	 *
+	 * Built once from a batch of intervals. The intervals are sorted by their
+	 * lower bound and the tree is implicit: the root of a range [lo, hi] is
+	 * its midpoint, each slot keeps the max upper bound of its subtree.
+	 * Everything lives in flat arrays, no pointers, no rebalancing.
+	 */
+	template<typename BoundT, typename PayloadT = char>
+	class StaticIntervalTree {
+		public:
+			struct Interval {
+				BoundT low;
+				BoundT high;
+			};
+
+		private:
+			uint32_t m_n;
+			std::vector<Interval> m_ivl;		// sorted by low
+			std::vector<BoundT> m_max;			// max high of the implicit subtree
+			std::vector<PayloadT> m_payload;	// payloads in the same order
+
+			struct LowLess {
+				const BoundT * lows;
+				explicit LowLess(const BoundT * l) : lows(l) {}
+				bool operator()(uint32_t a, uint32_t b) const { return lows[a] < lows[b]; }
+			};
+
+		public:
+			/**
+			 * build from `n` intervals [lows[i], highs[i]], in O(nlogn)
+			 */
+			StaticIntervalTree(const BoundT lows[], const BoundT highs[], const PayloadT payloads[], uint32_t n) :
+				m_n(n), m_ivl(n), m_max(n), m_payload(n) {
+				std::vector<uint32_t> order(n);
+				for (uint32_t i = 0; i < n; i++) order[i] = i;
+				std::sort(order.begin(), order.end(), LowLess(lows));
+
+				for (uint32_t i = 0; i < n; i++) {
+					m_ivl[i].low = lows[order[i]];
+					m_ivl[i].high = highs[order[i]];
+					if (payloads != NULL) m_payload[i] = payloads[order[i]];
+				}
+				if (n > 0) build(0, n - 1);
+			}
+
+			uint32_t size() const { return m_n; }
+			const Interval & interval(uint32_t i) const { return m_ivl[i]; }
+			const PayloadT & payload(uint32_t i) const { return m_payload[i]; }
+
+			/**
+			 * report the index of all intervals overlapping [low, high]
+			 */
+			void overlaps(BoundT low, BoundT high, std::vector<uint32_t> & out) const {
+				if (m_n > 0) query(0, m_n - 1, low, high, out);
+			}
+
+			/**
+			 * report the index of all intervals containing `point`
+			 */
+			void stab(BoundT point, std::vector<uint32_t> & out) const {
+				if (m_n > 0) query(0, m_n - 1, point, point, out);
+			}
+
+		private:
+			BoundT build(uint32_t lo, uint32_t hi) {
+				uint32_t mid = lo + (hi - lo) / 2;
+				BoundT m = m_ivl[mid].high;
+				if (lo < mid) {
+					BoundT l = build(lo, mid - 1);
+					if (m < l) m = l;
+				}
+				if (mid < hi) {
+					BoundT r = build(mid + 1, hi);
+					if (m < r) m = r;
+				}
+				m_max[mid] = m;
+				return m;
+			}
+
+			void query(uint32_t lo, uint32_t hi, const BoundT & low, const BoundT & high, std::vector<uint32_t> & out) const {
+				while (true) {
+					uint32_t mid = lo + (hi - lo) / 2;
+					if (m_max[mid] < low) return;
+					if (lo < mid) query(lo, mid - 1, low, high, out);
+					if (high < m_ivl[mid].low) return;
+					if (!(m_ivl[mid].high < low)) out.push_back(mid);
+					if (mid == hi) return;
+					lo = mid + 1;
+				}
+			}
 	};
 }
 
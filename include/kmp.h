@@ -18,6 +18,7 @@
 #ifndef ALGO_KMP_H__
 #define ALGO_KMP_H__
 #include <string.h>
+#include <vector>
 
 namespace alg {
 	static void kmp_table(const char *W, int * T, int len);
@@ -32,9 +33,10 @@ namespace alg {
 
 		int m = 0;
 		int i = 0;
-		int T[LEN_W];
+		if (LEN_W == 0) return 0;
+		std::vector<int> T(LEN_W);
 
-		kmp_table(W,T, LEN_W);
+		kmp_table(W, &T[0], LEN_W);
 
 		while (m+i < LEN_S) {
 			if (W[i] == S[m+i]) {
@@ -65,7 +67,7 @@ namespace alg {
 		int pos = 2; // the current position we are computing in T 
 		int cnd = 0; // the next character of the current candidate substring
 		T[0] = -1;
-		T[1] = 0;
+		if (len > 1) T[1] = 0;
 
 		while (pos < len) {
 			// first case: the substring continues
@@ -20,7 +20,19 @@
  *     Proceedings of the American Mathematical Society, pp. 48–50 in 1956,
  * and was written by Joseph Kruskal.
  *
+ * Implementation:
+ * the edges are kept in one flat array, sorted once by radix sort on the
+ * weight, and cycles are rejected by a disjoint-set, O(E + E*alpha(V)).
+ *
+ * Also provided:
+ * - filter_kruskal_mst: quicksort-like partition on the weights, the heavy
+ *   half is filtered against the forest of the light half before sorting.
+ * - boruvka_mst: parallel Boruvka, each round every component picks its
+ *   lightest edge, scanned by several threads (C++11).
+ *
  * http://en.wikipedia.org/wiki/Kruskal's_algorithm
+ * http://en.wikipedia.org/wiki/Bor%C5%AFvka's_algorithm
+ * Osipov, Sanders & Singler, The Filter-Kruskal Minimum Spanning Tree Algorithm, 2009
  *
  * By Contibutor:xmuliang
  ******************************************************************************/
@@ -30,83 +42,216 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#endif
 #include "undirected_graph.h"
-#include "double_linked_list.h"
-#include "heap.h"
+#include "csr_graph.h"
+#include "disjoint-set.h"
 
 namespace alg {
-	class Kruskal {
-		private:
-			/**
-			 * Kruskal's Adjacent Lists, for Kruskal's Algorithm caculation
-			 */
-			struct KruskalAdjacent {
-				Heap<Graph::Vertex*> heap; 		// binary heap representation of weight->node
-				// the top of the heap is always the minimal element
-				const Graph::Vertex & v;
+	/**
+	 * stable LSD radix sort of edges by weight, 8 bits per pass,
+	 * passes where every key has the same byte are skipped.
+	 */
+	static void radix_sort_edges(WeightedEdge * edges, uint32_t m) {
+		if (m < 2) return;
+		WeightedEdge * temp = new WeightedEdge[m];
+		WeightedEdge * src = edges, * dst = temp;
+
+		for (int byte = 0; byte < 4; byte++) {
+			uint32_t count[256];
+			memset(count, 0, sizeof(count));
+			int shift = byte * 8;
+			for (uint32_t i = 0; i < m; i++) {
+				// flip the sign bit, so negative weights come first
+				count[(((uint32_t)src[i].weight ^ 0x80000000u) >> shift) & 0xff]++;
+			}
+			if (count[(((uint32_t)src[0].weight ^ 0x80000000u) >> shift) & 0xff] == m) continue;
 
-				KruskalAdjacent(const Graph::Vertex & vertex, uint32_t num_neigh):heap(num_neigh),v(vertex) { }
+			uint32_t index[256];
+			index[0] = 0;
+			for (int i = 1; i < 256; i++) index[i] = index[i-1] + count[i-1];
+			for (uint32_t i = 0; i < m; i++) {
+				dst[index[(((uint32_t)src[i].weight ^ 0x80000000u) >> shift) & 0xff]++] = src[i];
+			}
+			WeightedEdge * t = src; src = dst; dst = t;
+		}
 
-				struct list_head pa_node;
-			};
+		if (src != edges) memcpy(edges, src, sizeof(WeightedEdge) * m);
+		delete [] temp;
+	}
 
-			/**
-			 * Kruskal's Graph, simplified to list.
-			 */
-			typedef struct list_head KruskalGraph;
-		private:
-			KruskalGraph m_pg;
-			uint32_t num_vertex;
-		public:
-			/**
-			 * construct Kruskal's DataStrcuture by a given graph
-			 */
-			Kruskal(const Graph & g) {
-				INIT_LIST_HEAD(&m_pg);
+	/**
+	 * Kruskal's algorithm over n vertices and m edges.
+	 * the edges are sorted in place, the spanning forest is appended to mst.
+	 * returns the total weight.
+	 */
+	static int64_t kruskal_mst(uint32_t n, WeightedEdge edges[], uint32_t m, std::vector<WeightedEdge> & mst) {
+		radix_sort_edges(edges, m);
+		DisjointSet ds(n);
+		int64_t total = 0;
+		for (uint32_t i = 0; i < m && ds.count() > 1; i++) {
+			if (ds.unite(edges[i].u, edges[i].v)) {
+				mst.push_back(edges[i]);
+				total += edges[i].weight;
+			}
+		}
+		return total;
+	}
+
+	namespace detail {
+		static const uint32_t FILTER_KRUSKAL_THRESHOLD = 4096;
+
+		/**
+		 * depth: the partitions left before falling back to a plain sort,
+		 * against the pivots that split off a few edges at a time. the
+		 * heavy side is a loop, only the light side recurses.
+		 */
+		static void filter_kruskal(WeightedEdge * edges, uint32_t m, DisjointSet & ds,
+				std::vector<WeightedEdge> & mst, int64_t & total, uint32_t depth) {
+			while (m > FILTER_KRUSKAL_THRESHOLD && depth > 0 && ds.count() > 1) {
+				depth--;
+				int32_t a = edges[0].weight, b = edges[m/2].weight, c = edges[m-1].weight;
+				int32_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+				// light: weight <= pivot
+				uint32_t l = 0;
+				for (uint32_t i = 0; i < m; i++) {
+					if (edges[i].weight <= pivot) std::swap(edges[i], edges[l++]);
+				}
+				if (l == m) break;	// the pivot is the heaviest weight, no split
+
+				filter_kruskal(edges, l, ds, mst, total, depth);
 
-				Graph::Adjacent * a;
-				list_for_each_entry(a, &g.list(), a_node){
-					add_adjacent(*a);
+				// drop the heavy edges already inside one component
+				uint32_t h = l;
+				for (uint32_t i = l; i < m; i++) {
+					if (ds.find(edges[i].u) != ds.find(edges[i].v)) edges[h++] = edges[i];
 				}
-				this->num_vertex=g.vertex_count();
+				edges += l;
+				m = h - l;
 			}
+			if (m == 0 || ds.count() == 1) return;
 
-			~Kruskal() {
-				KruskalAdjacent * pa, *pan;
-				list_for_each_entry_safe(pa, pan, &m_pg, pa_node){
-					list_del(&pa->pa_node);
-					delete pa;
+			radix_sort_edges(edges, m);
+			for (uint32_t i = 0; i < m && ds.count() > 1; i++) {
+				if (ds.unite(edges[i].u, edges[i].v)) {
+					mst.push_back(edges[i]);
+					total += edges[i].weight;
 				}
 			}
-		private:
-			Kruskal(const Kruskal&);
-			Kruskal& operator= (const Kruskal&);
-		private:
-			/**
-			 * add an adjacent list to Kruskal's graph
-			 */
-			void add_adjacent(const Graph::Adjacent & a) {
-				KruskalAdjacent * pa = new KruskalAdjacent(a.vertex(), a.num_neigh);
-				list_add_tail(&pa->pa_node, &m_pg);
+		}
+	}
+
+	/**
+	 * Filter-Kruskal, faster than Kruskal when the MST only needs a small
+	 * part of the (sorted) edges. the edges are reordered in place.
+	 */
+	static int64_t filter_kruskal_mst(uint32_t n, WeightedEdge edges[], uint32_t m, std::vector<WeightedEdge> & mst) {
+		DisjointSet ds(n);
+		int64_t total = 0;
+		uint32_t depth = 0;
+		for (uint32_t k = m; k > 1; k >>= 1) depth += 2;	// 2 log2(m)
+		detail::filter_kruskal(edges, m, ds, mst, total, depth);
+		return total;
+	}
+
+#if __cplusplus >= 201103L
+	/**
+	 * parallel Boruvka.
+	 *
+	 * each round, the threads scan a slice of the live edges and record the
+	 * lightest edge leaving every component with an atomic min on
+	 * (weight, edge index); ties are broken by the index, so the chosen edges
+	 * never form a cycle. then the chosen edges are merged, and the edges
+	 * inside one component are dropped. O(logV) rounds.
+	 */
+	static int64_t boruvka_mst(uint32_t n, const WeightedEdge edges[], uint32_t m,
+			std::vector<WeightedEdge> & mst, int nthreads = 0) {
+		if (nthreads <= 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+
+		const uint64_t NONE = UINT64_MAX;
+		ConcurrentDisjointSet ds(n);
+		std::vector<std::atomic<uint64_t> > cheapest(n);
+		for (uint32_t i = 0; i < n; i++) cheapest[i].store(NONE, std::memory_order_relaxed);
+
+		std::vector<uint32_t> live(m);		// indices of the edges still crossing components
+		for (uint32_t i = 0; i < m; i++) live[i] = i;
 
-				Graph::Vertex * v;
-				list_for_each_entry(v, &a.v_head, v_node){
-					pa->heap.push(v->weight, v);  // weight->vertex
+		int64_t total = 0;
+		while (!live.empty()) {
+			uint32_t nlive = (uint32_t)live.size();
+			std::vector<std::thread> workers;
+			for (int t = 0; t < nthreads; t++) {
+				workers.push_back(std::thread([&, t]() {
+					uint32_t begin = (uint64_t)nlive * t / nthreads;
+					uint32_t end = (uint64_t)nlive * (t + 1) / nthreads;
+					for (uint32_t i = begin; i < end; i++) {
+						const WeightedEdge & e = edges[live[i]];
+						uint32_t cu = ds.find(e.u), cv = ds.find(e.v);
+						if (cu == cv) { live[i] = UINT32_MAX; continue; }
+						uint64_t key = ((uint64_t)((uint32_t)e.weight ^ 0x80000000u) << 32) | live[i];
+						uint32_t c[2] = {cu, cv};
+						for (int k = 0; k < 2; k++) {
+							uint64_t cur = cheapest[c[k]].load(std::memory_order_relaxed);
+							while (key < cur && !cheapest[c[k]].compare_exchange_weak(cur, key)) {}
+						}
+					}
+				}));
+			}
+			for (int t = 0; t < nthreads; t++) workers[t].join();
+
+			// merge along the chosen edges, an edge may be chosen by both sides
+			bool merged = false;
+			for (uint32_t v = 0; v < n; v++) {
+				uint64_t key = cheapest[v].load(std::memory_order_relaxed);
+				if (key == NONE) continue;
+				cheapest[v].store(NONE, std::memory_order_relaxed);
+				const WeightedEdge & e = edges[(uint32_t)key];
+				if (ds.unite(e.u, e.v)) {
+					mst.push_back(e);
+					total += e.weight;
+					merged = true;
 				}
 			}
+			if (!merged) break;
+
+			live.erase(std::remove(live.begin(), live.end(), UINT32_MAX), live.end());
+		}
+		return total;
+	}
+#endif
+
+	class Kruskal {
+		private:
+			CSRGraph m_g;
+			std::vector<WeightedEdge> m_edges;		// each undirected edge once
 
+		public:
 			/**
-			 * lookup up a given id
-			 * the related adjacent list is returned.
+			 * construct Kruskal's DataStrcuture by a given graph
 			 */
-			KruskalAdjacent * lookup(uint32_t id) const {
-				KruskalAdjacent * pa;
-				list_for_each_entry(pa, &m_pg, pa_node){
-					if (pa->v.id == id) { return pa;}
+			Kruskal(const Graph & g) : m_g(g) {
+				for (uint32_t u = 0; u < m_g.vertex_count(); u++) {
+					for (uint32_t e = m_g.begin(u); e < m_g.end(u); e++) {
+						if (u < m_g.target(e)) {
+							WeightedEdge we = {u, m_g.target(e), m_g.weight(e)};
+							m_edges.push_back(we);
+						}
+					}
 				}
-
-				return NULL;
 			}
+
+		private:
+			Kruskal(const Kruskal&);
+			Kruskal& operator= (const Kruskal&);
+
 		public:
 			/**
 			 * Kruskal's Algorithm.
@@ -123,79 +268,31 @@ namespace alg {
 			 */
 			Graph * run() {
 				UndirectedGraph * mst = new UndirectedGraph(); // empty Grapph
+				for (uint32_t i = 0; i < m_g.vertex_count(); i++) {
+					mst->add_vertex(m_g.id(i));
+				}
 
-				uint32_t mark[num_vertex];//    mark the different set
-				for(uint32_t i=0;i<num_vertex;i++)
-					mark[i]=i;            //    initialize the mark array with the unique value
-
-				const Graph::Vertex * v;
-				KruskalAdjacent * pa;
-				uint32_t flag=0;    //record the edge to be added into the mst
-				uint32_t total_nodes=num_vertex;    //nodes of the Kruskal
-
-				while(true) {
-					int weight = INT_MAX;
-					uint32_t best_to;
-					struct KruskalAdjacent * best_from;
-
-					// choose the smallest edge from the original graph
-					list_for_each_entry(pa, &m_pg, pa_node){
-						if(!pa->heap.is_empty()&&pa->heap.min_key()<weight) {
-							weight = pa->heap.min_key();
-							v = pa->heap.min_value();
-							best_to = v->id;
-							best_from = pa;
-						}
-					}
-
-					// loop until the chosen edges to total_nodes-1
-					if (flag<(total_nodes-1)&&(weight != INT_MAX)) {
-						// if the node not been added,construct it
-						if((*mst)[best_from->v.id]==NULL) {
-							mst->add_vertex(best_from->v.id);
-						}
-
-						if((*mst)[best_to]==NULL) {
-							mst->add_vertex(best_to);
-						}
-
-						// two nodes must belongs to set,to keep uncircle
-						if(mark[best_from->v.id]!=mark[best_to]) {
-							mst->add_edge(best_from->v.id, best_to, weight);
-
-							uint32_t tmp=mark[best_to];
-							for(uint32_t i=0;i<num_vertex;i++) {
-								if(mark[i]==tmp)
-									mark[i]=mark[best_from->v.id];
-							}
-							flag++;
-						}
-
-						best_from->heap.delete_min();
-						lookup(best_to)->heap.delete_min();
-					} else break;
+				std::vector<WeightedEdge> tree;
+				if (!m_edges.empty()) {
+					kruskal_mst(m_g.vertex_count(), &m_edges[0], (uint32_t)m_edges.size(), tree);
+				}
+				for (uint32_t i = 0; i < tree.size(); i++) {
+					mst->add_edge(m_g.id(tree[i].u), m_g.id(tree[i].v), tree[i].weight);
 				}
 
 				return mst;
 			}
 
 			/**
-			 * print the KruskalGraph
+			 * print the edges of the KruskalGraph
 			 */
 			void print() {
-				struct KruskalAdjacent * pa;
 				printf("Kruskal Graph: \n");
-				list_for_each_entry(pa, &m_pg, pa_node){
-					printf("%d->{", pa->v.id);
-					for(uint32_t i=0;i<pa->heap.count();i++) {
-						Graph::Vertex * v = pa->heap[i];
-						printf("id:%d->w:%d \t", v->id, v->weight);
-					}
-					printf("}\n");
+				for (uint32_t i = 0; i < m_edges.size(); i++) {
+					printf("%d-%d (w:%d)\n", m_g.id(m_edges[i].u), m_g.id(m_edges[i].v), m_edges[i].weight);
 				}
 			}
 	};
 }
 
 #endif //
-
@@ -0,0 +1,810 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * MAXIMUM FLOW ON SPARSE NETWORKS
+ *
+ * Features:
+ * 1. FlowNetwork: the residual graph in adjacency arrays, O(V + E) memory.
+ *    every edge is stored with its reverse arc, the arcs of a vertex are
+ *    contiguous (CSR order) and an arc knows the slot of its twin.
+ * 2. Dinic: BFS levels, then blocking flows along level-increasing arcs
+ *    with a current-arc pointer per vertex, O(V^2 E), O(E sqrt(V)) on unit
+ *    capacity networks such as bipartite matching.
+ * 3. Push-relabel, highest label first, O(V^2 sqrt(E)), with
+ *    - gap heuristic: when no vertex is left at some height, everything
+ *      above it is cut off from the sink and lifted to V at once
+ *    - global relabel: exact heights by a backward BFS from the sink, at
+ *      the start and after every O(V + E) worth of relabels
+ *    a second phase returns the excess stuck in the source side, so that
+ *    the result is a valid flow, not only a preflow.
+ * 4. MinCostFlow: successive shortest paths with Johnson potentials, in
+ *    the excess form of the Hungarian method. the arcs out of s are
+ *    saturated up front, then each vertex holding excess runs its own
+ *    Dijkstra on the reduced costs and stops at t, so a search only sees
+ *    the part of the graph near its augmenting path. vertices found unable
+ *    to reach t are never searched again; what can't reach t goes back to
+ *    s along shortest paths at the end.
+ *
+ * All three take the same FlowNetwork, leave the residual in it, and
+ * flow(e) tells the flow on an added edge. EdmondsKarp and RelabelToFront
+ * keep a dense residual matrix and suit small graphs only.
+ *
+ * http://en.wikipedia.org/wiki/Dinic%27s_algorithm
+ * http://en.wikipedia.org/wiki/Push%E2%80%93relabel_maximum_flow_algorithm
+ * http://en.wikipedia.org/wiki/Minimum-cost_flow_problem
+ * Cherkassky & Goldberg, On Implementing Push-Relabel Method for the
+ * Maximum Flow Problem, 1997
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_MAX_FLOW_H__
+#define ALGO_MAX_FLOW_H__
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "csr_graph.h"
+#include "heap.h"
+
+namespace alg {
+	static const uint32_t FLOW_NIL = UINT32_MAX;
+
+	class FlowNetwork {
+		private:
+			struct Edge {
+				uint32_t u;
+				uint32_t v;
+				int64_t cap;
+				int64_t cost;
+			};
+
+			uint32_t m_n;
+			std::vector<Edge> m_edges;			// as added
+			bool m_built;
+
+			// residual graph, arcs of u are [m_offset[u], m_offset[u+1])
+			std::vector<uint32_t> m_offset;
+			std::vector<uint32_t> m_to;
+			std::vector<uint32_t> m_rev;		// slot of the reverse arc
+			std::vector<int64_t> m_cap;			// residual capacity
+			std::vector<int64_t> m_cost;		// cost per unit, negated on reverse arcs
+			std::vector<uint32_t> m_arc;		// edge -> its forward arc
+
+		public:
+			explicit FlowNetwork(uint32_t n) : m_n(n), m_built(false) {}
+
+			/**
+			 * a network from a graph, the weights are the capacities.
+			 * the vertices are numbered as in g.
+			 */
+			explicit FlowNetwork(const CSRGraph & g) : m_n(g.vertex_count()), m_built(false) {
+				m_edges.reserve(g.edge_count());
+				for (uint32_t u = 0; u < m_n; u++) {
+					for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+						add_edge(u, g.target(e), g.weight(e));
+					}
+				}
+			}
+
+			/**
+			 * add an edge u->v, returns its number for flow().
+			 * the cost per unit is used by MinCostFlow only.
+			 */
+			uint32_t add_edge(uint32_t u, uint32_t v, int64_t cap, int64_t cost = 0) {
+				if (u >= m_n || v >= m_n) throw std::out_of_range("vertex out of range");
+				if (cap < 0) throw std::invalid_argument("negative capacity");
+				Edge e = {u, v, cap, cost};
+				m_edges.push_back(e);
+				m_built = false;
+				return (uint32_t)m_edges.size() - 1;
+			}
+
+			uint32_t vertex_count() const { return m_n; }
+			uint32_t edge_count() const { return (uint32_t)m_edges.size(); }
+
+			/**
+			 * the flow on edge e after a max flow run
+			 */
+			int64_t flow(uint32_t e) const {
+				return m_built ? m_edges[e].cap - m_cap[m_arc[e]] : 0;
+			}
+
+			/**
+			 * restore every residual capacity, forgetting the flow
+			 */
+			void reset() {
+				if (!m_built) return;
+				for (uint32_t e = 0; e < m_edges.size(); e++) {
+					m_cap[m_arc[e]] = m_edges[e].cap;
+					m_cap[m_rev[m_arc[e]]] = 0;
+				}
+			}
+
+			/**
+			 * lay out the residual graph, done by the algorithms on demand
+			 */
+			void build() {
+				if (m_built) return;
+				uint32_t m = (uint32_t)m_edges.size();
+				m_offset.assign(m_n + 1, 0);
+				for (uint32_t i = 0; i < m; i++) {
+					m_offset[m_edges[i].u + 1]++;
+					m_offset[m_edges[i].v + 1]++;
+				}
+				for (uint32_t u = 0; u < m_n; u++) m_offset[u + 1] += m_offset[u];
+
+				m_to.resize(2 * m);
+				m_rev.resize(2 * m);
+				m_cap.resize(2 * m);
+				m_cost.resize(2 * m);
+				m_arc.resize(m);
+				std::vector<uint32_t> pos(m_offset.begin(), m_offset.end() - 1);
+				for (uint32_t i = 0; i < m; i++) {
+					const Edge & e = m_edges[i];
+					uint32_t a = pos[e.u]++;
+					uint32_t b = pos[e.v]++;
+					m_to[a] = e.v; m_cap[a] = e.cap; m_cost[a] = e.cost; m_rev[a] = b;
+					m_to[b] = e.u; m_cap[b] = 0; m_cost[b] = -e.cost; m_rev[b] = a;
+					m_arc[i] = a;
+				}
+				m_built = true;
+			}
+
+			/**
+			 * the vertices reachable from s in the residual graph, after a max
+			 * flow run they are the source side of a minimum cut.
+			 */
+			void source_side(uint32_t s, std::vector<bool> & side) {
+				build();
+				side.assign(m_n, false);
+				std::vector<uint32_t> queue(1, s);
+				side[s] = true;
+				for (size_t i = 0; i < queue.size(); i++) {
+					uint32_t u = queue[i];
+					for (uint32_t a = m_offset[u]; a < m_offset[u + 1]; a++) {
+						if (m_cap[a] > 0 && !side[m_to[a]]) {
+							side[m_to[a]] = true;
+							queue.push_back(m_to[a]);
+						}
+					}
+				}
+			}
+
+			friend class Dinic;
+			friend class PushRelabel;
+			friend class MinCostFlow;
+	};
+
+	/**
+	 * Dinic's blocking flow algorithm
+	 */
+	class Dinic {
+		private:
+			FlowNetwork & net;
+			std::vector<int32_t> m_level;
+			std::vector<uint32_t> m_cur;		// current arc
+			std::vector<uint32_t> m_queue;
+			std::vector<uint32_t> m_path;		// arcs from s
+
+		public:
+			explicit Dinic(FlowNetwork & network) : net(network) {}
+
+			/**
+			 * augment the flow of the network from s to t until maximal,
+			 * returns the flow added.
+			 */
+			int64_t run(uint32_t s, uint32_t t) {
+				net.build();
+				if (s == t) return 0;
+				uint32_t n = net.m_n;
+				m_level.resize(n);
+				m_cur.resize(n);
+
+				int64_t total = 0;
+				while (bfs(s, t)) {
+					std::copy(net.m_offset.begin(), net.m_offset.end() - 1, m_cur.begin());
+					total += blocking_flow(s, t);
+				}
+				return total;
+			}
+
+		private:
+			bool bfs(uint32_t s, uint32_t t) {
+				std::fill(m_level.begin(), m_level.end(), -1);
+				m_queue.clear();
+				m_queue.push_back(s);
+				m_level[s] = 0;
+				for (size_t i = 0; i < m_queue.size(); i++) {
+					uint32_t u = m_queue[i];
+					// the level of t is complete, nothing beyond can be on a path
+					if (m_level[t] >= 0 && m_level[u] >= m_level[t]) break;
+					for (uint32_t a = net.m_offset[u]; a < net.m_offset[u + 1]; a++) {
+						uint32_t v = net.m_to[a];
+						if (net.m_cap[a] > 0 && m_level[v] < 0) {
+							m_level[v] = m_level[u] + 1;
+							m_queue.push_back(v);
+						}
+					}
+				}
+				return m_level[t] >= 0;
+			}
+
+			/**
+			 * advance along admissible arcs, augment on reaching t, retreat
+			 * from dead ends. iterative, the path is kept in m_path.
+			 */
+			int64_t blocking_flow(uint32_t s, uint32_t t) {
+				int64_t total = 0;
+				uint32_t u = s;
+				m_path.clear();
+				for (;;) {
+					if (u == t) {
+						int64_t f = net.m_cap[m_path[0]];
+						for (size_t i = 1; i < m_path.size(); i++) f = std::min(f, net.m_cap[m_path[i]]);
+						// augment, and go back to the tail of the first saturated arc
+						size_t back = m_path.size();
+						for (size_t i = 0; i < m_path.size(); i++) {
+							uint32_t a = m_path[i];
+							net.m_cap[a] -= f;
+							net.m_cap[net.m_rev[a]] += f;
+							if (net.m_cap[a] == 0 && back == m_path.size()) back = i;
+						}
+						total += f;
+						m_path.resize(back);
+						u = back == 0 ? s : net.m_to[m_path[back - 1]];
+						continue;
+					}
+
+					uint32_t & a = m_cur[u];
+					uint32_t end = net.m_offset[u + 1];
+					while (a < end && !(net.m_cap[a] > 0 && m_level[net.m_to[a]] == m_level[u] + 1)) a++;
+					if (a < end) {
+						m_path.push_back(a);
+						u = net.m_to[a];
+						continue;
+					}
+
+					// dead end
+					if (u == s) break;
+					m_level[u] = -1;
+					uint32_t last = m_path.back();
+					m_path.pop_back();
+					u = net.m_to[net.m_rev[last]];
+					m_cur[u]++;
+				}
+				return total;
+			}
+	};
+
+	/**
+	 * highest-label push-relabel with the gap & global relabel heuristics
+	 */
+	class PushRelabel {
+		private:
+			FlowNetwork & net;
+			uint32_t m_n;
+			uint32_t m_s, m_t;
+			std::vector<uint32_t> m_h;			// height
+			std::vector<int64_t> m_ex;			// excess
+			std::vector<uint32_t> m_cur;		// current arc
+			std::vector<std::vector<uint32_t> > m_active;	// active vertices by height
+			// every vertex below height n, by height, in doubly linked
+			// lists. node n + k is the head of list k.
+			std::vector<uint32_t> m_next, m_prev;
+			uint32_t m_hi;						// highest active height
+			uint32_t m_maxh;					// highest non empty list
+			uint64_t m_work;					// since the last global relabel
+
+		public:
+			explicit PushRelabel(FlowNetwork & network) : net(network) {}
+
+			/**
+			 * maximum flow from s to t on a network without flow,
+			 * returns the flow value.
+			 */
+			int64_t run(uint32_t s, uint32_t t) {
+				net.build();
+				if (s == t) return 0;
+				m_n = net.m_n;
+				m_s = s;
+				m_t = t;
+				m_h.assign(m_n, 0);
+				m_ex.assign(m_n, 0);
+				m_cur.assign(net.m_offset.begin(), net.m_offset.end() - 1);
+				m_active.assign(m_n, std::vector<uint32_t>());
+				m_next.assign(2 * m_n, FLOW_NIL);
+				m_prev.assign(2 * m_n, FLOW_NIL);
+
+				// saturate the arcs leaving s
+				for (uint32_t a = net.m_offset[s]; a < net.m_offset[s + 1]; a++) {
+					int64_t c = net.m_cap[a];
+					if (c == 0) continue;
+					net.m_cap[a] = 0;
+					net.m_cap[net.m_rev[a]] += c;
+					m_ex[net.m_to[a]] += c;
+					m_ex[s] -= c;
+				}
+
+				global_relabel();
+				while (m_hi != FLOW_NIL) {
+					std::vector<uint32_t> & bucket = m_active[m_hi];
+					if (bucket.empty()) {
+						m_hi = m_hi == 0 ? FLOW_NIL : m_hi - 1;
+						continue;
+					}
+					uint32_t u = bucket.back();
+					bucket.pop_back();
+					discharge(u);
+					if (m_work > 6 * (uint64_t)m_n + net.m_to.size()) global_relabel();
+				}
+
+				int64_t value = m_ex[t];
+				return_excess();
+				return value;
+			}
+
+		private:
+			inline uint32_t head(uint32_t h) const { return m_n + h; }
+
+			void list_insert(uint32_t u, uint32_t h) {
+				uint32_t hd = head(h);
+				uint32_t nx = m_next[hd];
+				m_next[u] = nx;
+				m_prev[u] = hd;
+				if (nx != FLOW_NIL) m_prev[nx] = u;
+				m_next[hd] = u;
+				if (h > m_maxh || m_maxh == FLOW_NIL) m_maxh = h;
+			}
+
+			void list_remove(uint32_t u) {
+				uint32_t pv = m_prev[u], nx = m_next[u];
+				m_next[pv] = nx;
+				if (nx != FLOW_NIL) m_prev[nx] = pv;
+			}
+
+			inline bool list_empty(uint32_t h) const { return m_next[head(h)] == FLOW_NIL; }
+
+			void activate(uint32_t v) {
+				if (v == m_s || v == m_t || m_h[v] >= m_n) return;
+				m_active[m_h[v]].push_back(v);
+				if (m_hi == FLOW_NIL || m_h[v] > m_hi) m_hi = m_h[v];
+			}
+
+			/**
+			 * exact distances to t in the residual graph, by BFS on the
+			 * reverse arcs; the vertices cut off from t get height n.
+			 */
+			void global_relabel() {
+				m_work = 0;
+				std::fill(m_h.begin(), m_h.end(), m_n);
+				for (uint32_t k = 0; k < m_n; k++) {
+					m_active[k].clear();
+					m_next[head(k)] = FLOW_NIL;
+				}
+				m_hi = FLOW_NIL;
+				m_maxh = FLOW_NIL;
+
+				std::vector<uint32_t> queue(1, m_t);
+				m_h[m_t] = 0;
+				for (size_t i = 0; i < queue.size(); i++) {
+					uint32_t v = queue[i];
+					for (uint32_t a = net.m_offset[v]; a < net.m_offset[v + 1]; a++) {
+						uint32_t u = net.m_to[a];
+						// arc u->v is the twin of a
+						if (m_h[u] == m_n && u != m_s && net.m_cap[net.m_rev[a]] > 0) {
+							m_h[u] = m_h[v] + 1;
+							queue.push_back(u);
+						}
+					}
+				}
+
+				for (size_t i = 0; i < queue.size(); i++) {
+					uint32_t u = queue[i];
+					m_cur[u] = net.m_offset[u];
+					list_insert(u, m_h[u]);
+					if (m_ex[u] > 0) activate(u);
+				}
+			}
+
+			void push(uint32_t u, uint32_t a) {
+				uint32_t v = net.m_to[a];
+				int64_t f = std::min(m_ex[u], net.m_cap[a]);
+				net.m_cap[a] -= f;
+				net.m_cap[net.m_rev[a]] += f;
+				m_ex[u] -= f;
+				if (m_ex[v] == 0) {
+					m_ex[v] = f;
+					activate(v);
+				} else {
+					m_ex[v] += f;
+				}
+			}
+
+			void discharge(uint32_t u) {
+				while (m_ex[u] > 0) {
+					uint32_t end = net.m_offset[u + 1];
+					uint32_t & a = m_cur[u];
+					for (; a < end; a++) {
+						if (net.m_cap[a] > 0 && m_h[u] == m_h[net.m_to[a]] + 1) {
+							push(u, a);
+							if (m_ex[u] == 0) return;
+						}
+					}
+
+					// relabel
+					uint32_t old = m_h[u];
+					uint32_t h = 2 * m_n;
+					for (uint32_t b = net.m_offset[u]; b < end; b++) {
+						if (net.m_cap[b] > 0) h = std::min(h, m_h[net.m_to[b]] + 1);
+					}
+					m_work += end - net.m_offset[u] + 12;
+					list_remove(u);
+
+					if (list_empty(old)) {
+						gap(old);
+						m_h[u] = m_n;
+						return;
+					}
+					if (h >= m_n) {
+						m_h[u] = m_n;
+						return;
+					}
+					m_h[u] = h;
+					m_cur[u] = net.m_offset[u];
+					list_insert(u, h);
+				}
+			}
+
+			/**
+			 * no vertex is left at height g, the ones above can't reach t
+			 */
+			void gap(uint32_t g) {
+				for (uint32_t k = g + 1; m_maxh != FLOW_NIL && k <= m_maxh; k++) {
+					for (uint32_t v = m_next[head(k)]; v != FLOW_NIL; v = m_next[v]) m_h[v] = m_n;
+					m_next[head(k)] = FLOW_NIL;
+					m_active[k].clear();
+				}
+				m_maxh = g == 0 ? FLOW_NIL : g - 1;
+				if (m_hi != FLOW_NIL && m_hi > m_maxh) m_hi = m_maxh;
+			}
+
+			/**
+			 * second phase: the preflow is turned into a flow by sending the
+			 * excess left in the source side back to s. FIFO push-relabel
+			 * with heights starting at the BFS distance to s.
+			 */
+			void return_excess() {
+				std::fill(m_h.begin(), m_h.end(), FLOW_NIL);
+				std::vector<uint32_t> queue(1, m_s);
+				m_h[m_s] = 0;
+				for (size_t i = 0; i < queue.size(); i++) {
+					uint32_t v = queue[i];
+					for (uint32_t a = net.m_offset[v]; a < net.m_offset[v + 1]; a++) {
+						uint32_t u = net.m_to[a];
+						if (m_h[u] == FLOW_NIL && u != m_t && net.m_cap[net.m_rev[a]] > 0) {
+							m_h[u] = m_h[v] + 1;
+							queue.push_back(u);
+						}
+					}
+				}
+
+				queue.clear();
+				for (uint32_t u = 0; u < m_n; u++) {
+					m_cur[u] = net.m_offset[u];
+					if (u != m_s && u != m_t && m_ex[u] > 0) queue.push_back(u);
+				}
+				for (size_t i = 0; i < queue.size(); i++) {
+					uint32_t u = queue[i];
+					while (m_ex[u] > 0) {
+						uint32_t end = net.m_offset[u + 1];
+						uint32_t & a = m_cur[u];
+						for (; a < end && m_ex[u] > 0; a++) {
+							uint32_t v = net.m_to[a];
+							if (v == m_t || net.m_cap[a] == 0 || m_h[u] != m_h[v] + 1) continue;
+							int64_t f = std::min(m_ex[u], net.m_cap[a]);
+							net.m_cap[a] -= f;
+							net.m_cap[net.m_rev[a]] += f;
+							m_ex[u] -= f;
+							if (m_ex[v] == 0 && v != m_s) queue.push_back(v);
+							m_ex[v] += f;
+						}
+						if (m_ex[u] == 0) break;
+						uint32_t h = FLOW_NIL;
+						for (uint32_t b = net.m_offset[u]; b < end; b++) {
+							uint32_t v = net.m_to[b];
+							if (v != m_t && net.m_cap[b] > 0 && m_h[v] != FLOW_NIL) h = std::min(h, m_h[v] + 1);
+						}
+						m_h[u] = h;
+						m_cur[u] = net.m_offset[u];
+					}
+				}
+			}
+	};
+	/**
+	 * min-cost flow by successive shortest paths
+	 */
+	class MinCostFlow {
+		private:
+			FlowNetwork & net;
+			std::vector<int64_t> m_pot;			// potentials
+			std::vector<int64_t> m_ex;			// excess
+			std::vector<int64_t> m_dist;
+			std::vector<uint32_t> m_prev;		// arc into a vertex on the search tree
+			std::vector<bool> m_done;			// settled by the current search
+			std::vector<bool> m_dead;			// can't reach t any more
+			std::vector<uint32_t> m_touched;	// labelled by the current search
+			std::vector<uint32_t> m_settled;
+			IndexedHeap<int64_t> m_heap;
+			int64_t m_lazy;						// pending shift of the dead potentials
+			int64_t m_cost;
+
+		public:
+			explicit MinCostFlow(FlowNetwork & network) : net(network), m_heap(0) {}
+
+			/**
+			 * send up to `limit` units from s to t at the minimum cost, on a
+			 * network without flow and without negative cost cycles.
+			 * returns the flow sent, `cost` is set to its total cost.
+			 * throws std::overflow_error if a cost doesn't fit in int64_t.
+			 */
+			int64_t run(uint32_t s, uint32_t t, int64_t & cost, int64_t limit = INT64_MAX) {
+				net.build();
+				cost = 0;
+				if (s == t || limit <= 0) return 0;
+				uint32_t n = net.m_n;
+				const int64_t INF = INT64_MAX;
+				m_pot.assign(n, 0);
+				m_ex.assign(n, 0);
+				m_dist.assign(n, INF);
+				m_prev.assign(n, FLOW_NIL);
+				m_done.assign(n, false);
+				m_dead.assign(n, false);
+				m_heap = IndexedHeap<int64_t>(n);
+				m_lazy = 0;
+				m_cost = 0;
+
+				init_potentials(s);
+
+				// no more than this can leave s or arrive at t
+				int64_t in_t = 0, out_s = 0;
+				for (uint32_t a = 0; a < net.m_to.size(); a++) {
+					if (net.m_cap[a] > 0 && net.m_to[a] == t) in_t = sat_add(in_t, net.m_cap[a]);
+				}
+				for (uint32_t a = net.m_offset[s]; a < net.m_offset[s + 1]; a++) {
+					if (net.m_to[a] != s) out_s = sat_add(out_s, net.m_cap[a]);
+				}
+				int64_t bound = std::min(std::min(in_t, out_s), limit);
+
+				// lower the potential of s until no arc out of s has a positive
+				// reduced cost, then saturate them, the excess lands at the
+				// heads of the arcs. a head takes no more than it can pass on
+				// (bound for t), the cheapest arcs first.
+				std::vector<uint32_t> out;
+				for (uint32_t a = net.m_offset[s]; a < net.m_offset[s + 1]; a++) {
+					uint32_t v = net.m_to[a];
+					if (net.m_cap[a] == 0 || v == s) continue;
+					m_pot[s] = std::min(m_pot[s], m_pot[v] - net.m_cost[a]);
+					out.push_back(a);
+				}
+				std::stable_sort(out.begin(), out.end(), CostLess(net.m_cost));
+				std::vector<int64_t> room(n, -1);
+				std::vector<std::pair<uint32_t, int64_t> > hidden;
+				std::vector<uint32_t> active;
+				for (size_t i = 0; i < out.size(); i++) {
+					uint32_t a = out[i], v = net.m_to[a];
+					if (room[v] < 0) {
+						room[v] = v == t ? bound : 0;
+						for (uint32_t b = net.m_offset[v]; v != t && b < net.m_offset[v + 1]; b++) {
+							if (net.m_to[b] != s) room[v] = sat_add(room[v], net.m_cap[b]);
+						}
+						room[v] = std::min(room[v], bound);
+					}
+					int64_t f = std::min(net.m_cap[a], room[v]);
+					room[v] -= f;
+					// the capacity above f is never used, keep it out of sight
+					if (net.m_cap[a] > f) hidden.push_back(std::make_pair(a, net.m_cap[a] - f));
+					net.m_cap[a] = 0;
+					net.m_cap[net.m_rev[a]] += f;
+					if (m_ex[v] == 0 && f > 0 && v != t) active.push_back(v);
+					m_ex[v] += f;
+					add_cost(f, net.m_cost[a]);
+				}
+
+				// every excess goes to t along a shortest path from where it
+				// is. the searches are local, and only the vertices settled by
+				// a search get new potentials. s has no residual arc out until
+				// the excess is returned, it starts out dead.
+				m_dead[s] = true;
+				for (size_t i = 0; i < active.size() && m_ex[t] < limit; i++) {
+					uint32_t v = active[i];
+					while (m_ex[v] > 0 && m_ex[t] < limit && !m_dead[v]) {
+						if (!search(v, t, true)) {
+							// nothing settled can reach t, now or later
+							for (size_t k = 0; k < m_settled.size(); k++) {
+								m_dead[m_settled[k]] = true;
+								m_pot[m_settled[k]] += m_lazy;
+							}
+							reset();
+							break;
+						}
+						augment(v, t, std::min(m_ex[v], limit - m_ex[t]));
+					}
+				}
+
+				// the rest goes back to s, again along shortest paths
+				for (uint32_t v = 0; v < n; v++) {
+					if (m_dead[v]) m_pot[v] -= m_lazy;
+				}
+				std::fill(m_dead.begin(), m_dead.end(), false);
+				while (m_ex[t] > limit) {
+					search(t, s, false);
+					augment(t, s, m_ex[t] - limit);
+				}
+				for (size_t i = 0; i < active.size(); i++) {
+					uint32_t v = active[i];
+					while (m_ex[v] > 0) {
+						search(v, s, false);
+						augment(v, s, m_ex[v]);
+					}
+				}
+
+				for (size_t i = 0; i < hidden.size(); i++) net.m_cap[hidden[i].first] += hidden[i].second;
+				cost = m_cost;
+				return m_ex[t];
+			}
+
+		private:
+			struct CostLess {
+				const std::vector<int64_t> & cost;
+				explicit CostLess(const std::vector<int64_t> & cost) : cost(cost) {}
+				bool operator()(uint32_t a, uint32_t b) const { return cost[a] < cost[b]; }
+			};
+
+			static int64_t sat_add(int64_t a, int64_t b) {
+				return b > INT64_MAX - a ? INT64_MAX : a + b;
+			}
+
+			/**
+			 * m_cost += f * c, f >= 0
+			 */
+			void add_cost(int64_t f, int64_t c) {
+				if ((c > 0 && f > INT64_MAX / c) || (c < -1 && f > INT64_MIN / c)) {
+					throw std::overflow_error("cost overflow");
+				}
+				int64_t p = f * c;
+				if (p > 0 ? m_cost > INT64_MAX - p : m_cost < INT64_MIN - p) {
+					throw std::overflow_error("cost overflow");
+				}
+				m_cost += p;
+			}
+
+			inline int64_t reduced(uint32_t u, uint32_t a) const {
+				return net.m_cost[a] + m_pot[u] - m_pot[net.m_to[a]];
+			}
+
+			/**
+			 * with negative costs, the first potentials are the distances
+			 * from s, by a queue based Bellman-Ford.
+			 */
+			void init_potentials(uint32_t s) {
+				uint32_t n = net.m_n;
+				bool negative = false;
+				for (uint32_t a = 0; a < net.m_to.size(); a++) {
+					if (net.m_cap[a] > 0 && net.m_cost[a] < 0) { negative = true; break; }
+				}
+				if (!negative) return;
+
+				const int64_t INF = INT64_MAX;
+				std::vector<bool> queued(n, false);
+				std::vector<uint32_t> queue;
+				m_dist[s] = 0;
+				queue.push_back(s);
+				queued[s] = true;
+				for (size_t i = 0; i < queue.size(); i++) {
+					uint32_t u = queue[i];
+					queued[u] = false;
+					for (uint32_t a = net.m_offset[u]; a < net.m_offset[u + 1]; a++) {
+						uint32_t v = net.m_to[a];
+						if (net.m_cap[a] > 0 && m_dist[u] + net.m_cost[a] < m_dist[v]) {
+							m_dist[v] = m_dist[u] + net.m_cost[a];
+							if (!queued[v]) {
+								queued[v] = true;
+								queue.push_back(v);
+							}
+						}
+					}
+				}
+				for (uint32_t v = 0; v < n; v++) {
+					m_pot[v] = m_dist[v] == INF ? 0 : m_dist[v];
+					m_dist[v] = INF;
+				}
+			}
+
+			/**
+			 * Dijkstra on the reduced costs from src, stopping once dst is
+			 * settled. on success the settled vertices move their potential
+			 * by dist - dist[dst], which keeps every reduced cost non
+			 * negative and puts the path found at reduced cost 0.
+			 *
+			 * with prune, the dead vertices are not entered. their potentials
+			 * are lowered all together (lazily, by m_lazy) as far as the arcs
+			 * coming in from the settled vertices need; no arc leaves them
+			 * towards a live vertex.
+			 */
+			bool search(uint32_t src, uint32_t dst, bool prune) {
+				const int64_t INF = INT64_MAX;
+				IndexedHeap<int64_t> & Q = m_heap;
+				int64_t to_dead = INF;
+				m_dist[src] = 0;
+				m_touched.push_back(src);
+				Q.push(src, 0);
+				while (!Q.is_empty()) {
+					uint32_t u = Q.pop();
+					m_done[u] = true;
+					m_settled.push_back(u);
+					if (u == dst) break;
+					for (uint32_t a = net.m_offset[u]; a < net.m_offset[u + 1]; a++) {
+						uint32_t v = net.m_to[a];
+						if (net.m_cap[a] == 0 || m_done[v]) continue;
+						if (prune && m_dead[v]) {
+							to_dead = std::min(to_dead, m_dist[u] + reduced(u, a) + m_lazy);
+							continue;
+						}
+						int64_t d = m_dist[u] + reduced(u, a);
+						if (d < m_dist[v]) {
+							if (m_dist[v] == INF) m_touched.push_back(v);
+							m_dist[v] = d;
+							m_prev[v] = a;
+							Q.push(v, d);
+						}
+					}
+				}
+				if (!m_done[dst]) return false;
+
+				int64_t dt = m_dist[dst];
+				for (size_t i = 0; i < m_settled.size(); i++) {
+					uint32_t v = m_settled[i];
+					m_pot[v] += m_dist[v] - dt;
+				}
+				if (to_dead < dt) m_lazy += dt - to_dead;
+				return true;
+			}
+
+			/**
+			 * push up to f units along the search tree path from src to dst
+			 */
+			void augment(uint32_t src, uint32_t dst, int64_t f) {
+				for (uint32_t v = dst; v != src; v = net.m_to[net.m_rev[m_prev[v]]]) {
+					f = std::min(f, net.m_cap[m_prev[v]]);
+				}
+				for (uint32_t v = dst; v != src; v = net.m_to[net.m_rev[m_prev[v]]]) {
+					uint32_t a = m_prev[v];
+					net.m_cap[a] -= f;
+					net.m_cap[net.m_rev[a]] += f;
+					add_cost(f, net.m_cost[a]);
+				}
+				m_ex[src] -= f;
+				m_ex[dst] += f;
+				reset();
+			}
+
+			void reset() {
+				for (size_t i = 0; i < m_touched.size(); i++) {
+					uint32_t v = m_touched[i];
+					m_dist[v] = INT64_MAX;
+					m_done[v] = false;
+				}
+				m_touched.clear();
+				m_settled.clear();
+				m_heap.clear();
+			}
+
+	};
+}
+
+#endif //
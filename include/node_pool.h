@@ -0,0 +1,126 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * NODE POOL
+ *
+ * Features:
+ * 1. fixed-size node allocator for trees & lists
+ * 2. nodes are carved out of large chunks, O(1) alloc/free with a free-list
+ * 3. the whole pool is released chunk by chunk, without touching the nodes
+ *
+ * The pool hands out raw storage, construct with placement new.
+ * release() does NOT run destructors of the nodes.
+ *
+ * http://en.wikipedia.org/wiki/Memory_pool
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_NODE_POOL_H__
+#define ALGO_NODE_POOL_H__
+#include <stdlib.h>
+#include <stdint.h>
+#include <new>
+
+namespace alg {
+	template<typename T>
+	class NodePool {
+	private:
+		static const uint32_t MIN_CHUNK = 64;
+		static const uint32_t MAX_CHUNK = 65536;
+
+		union Slot {
+			Slot * next;				// when the slot is free
+			char data[sizeof(T)];		// when the slot is in use
+			// force the strictest alignment
+			long double ld;
+			uint64_t u64;
+			void * ptr;
+		};
+
+		struct Chunk {
+			Chunk * next;
+			Slot * slots;
+		};
+
+		Chunk * m_chunks;		// all chunks allocated
+		Slot * m_free;			// free-list of recycled slots
+		Slot * m_cur;			// bump pointer in the newest chunk
+		Slot * m_end;			// end of the newest chunk
+		uint32_t m_next_size;	// number of slots of the next chunk
+
+	public:
+		NodePool() : m_chunks(NULL), m_free(NULL), m_cur(NULL), m_end(NULL), m_next_size(MIN_CHUNK) {}
+		~NodePool() { release(); }
+
+	private:
+		NodePool(const NodePool &);
+		NodePool& operator=(const NodePool &);
+
+	public:
+		/**
+		 * storage for one node
+		 */
+		void * alloc() {
+			if (m_free != NULL) {
+				Slot * s = m_free;
+				m_free = s->next;
+				return s;
+			}
+			if (m_cur == m_end) new_chunk(m_next_size);
+			return m_cur++;
+		}
+
+		/**
+		 * give a node back to the pool, the node must have been destroyed.
+		 */
+		void free(void * p) {
+			Slot * s = static_cast<Slot *>(p);
+			s->next = m_free;
+			m_free = s;
+		}
+
+		/**
+		 * pre-allocate room for `n` nodes in one chunk, used by bulk construction.
+		 */
+		void reserve(uint32_t n) {
+			if ((uint32_t)(m_end - m_cur) < n) new_chunk(n);
+		}
+
+		/**
+		 * free every chunk at once.
+		 */
+		void release() {
+			while (m_chunks != NULL) {
+				Chunk * next = m_chunks->next;
+				::free(m_chunks);
+				m_chunks = next;
+			}
+			m_free = m_cur = m_end = NULL;
+			m_next_size = MIN_CHUNK;
+		}
+
+	private:
+		void new_chunk(uint32_t n) {
+			// the chunk header is placed in front of the slots
+			size_t header = (sizeof(Chunk) + sizeof(Slot) - 1) / sizeof(Slot) * sizeof(Slot);
+			Chunk * c = (Chunk *)malloc(header + (size_t)n * sizeof(Slot));
+			if (c == NULL) throw std::bad_alloc();
+			c->slots = (Slot *)((char *)c + header);
+			c->next = m_chunks;
+			m_chunks = c;
+
+			// recycle the tail of the previous chunk
+			while (m_cur != m_end) free(m_cur++);
+
+			m_cur = c->slots;
+			m_end = c->slots + n;
+			if (m_next_size < MAX_CHUNK) m_next_size *= 2;
+		}
+	};
+}
+
+#endif //
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * PAGERANK
+ *
+ * Features:
+ * 1. the power iteration, pull style: every vertex sums the contributions
+ *    rank(u) / outdeg(u) of its in-neighbours, over the transposed graph.
+ *    nothing is written but its own rank, so the vertices split over the
+ *    threads without locks or atomics.
+ * 2. the contributions are a flat array computed once per iteration, the
+ *    gather over the in-edges uses 4 independent sums; the threads get
+ *    ranges of equal in-edges + vertices.
+ * 3. the rank of dangling vertices (no out-edge) goes back through the
+ *    teleport vector. stops when the L1 change of an iteration is below
+ *    tol, or after max_iter.
+ * 4. personalized PageRank: the teleport goes to a set of seed vertices.
+ *
+ * The transposed graph is built once, a PageRank object runs any number
+ * of (personalized) rankings of the same graph.
+ *
+ * http://en.wikipedia.org/wiki/PageRank
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_PAGERANK_H__
+#define ALGO_PAGERANK_H__
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#if __cplusplus >= 201103L
+#include <thread>
+#endif
+#include "csr_graph.h"
+
+namespace alg {
+	class PageRank {
+		private:
+			uint32_t m_n;
+			CSRGraph m_in;					// the transposed graph
+			std::vector<double> m_inv_deg;	// 1 / outdeg, 0 for a dangling vertex
+			std::vector<uint32_t> m_range;	// vertices of thread t: [m_range[t], m_range[t+1])
+			std::vector<double> m_contrib, m_next;
+			std::vector<double> m_partial;	// per thread: dangling rank, then L1 change
+			int m_nthreads;
+
+		public:
+			/**
+			 * prepare the rankings of g on nthreads threads (C++11), 0 for
+			 * the hardware concurrency
+			 */
+			explicit PageRank(const CSRGraph & g, int nthreads = 0) : m_n(g.vertex_count()), m_in(g.transpose()),
+				m_inv_deg(g.vertex_count()), m_contrib(g.vertex_count()), m_next(g.vertex_count()) {
+				for (uint32_t u = 0; u < m_n; u++) m_inv_deg[u] = g.degree(u) ? 1.0 / g.degree(u) : 0.0;
+#if __cplusplus >= 201103L
+				if (nthreads <= 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+#else
+				nthreads = 1;
+#endif
+				m_nthreads = std::max(1, std::min<int>(nthreads, std::max(1u, m_n / 1024)));
+				m_partial.resize(m_nthreads);
+
+				// cost of v: its in-edges + 1, cut in equal parts
+				const uint32_t * off = m_in.offsets();
+				uint64_t total = (uint64_t)m_in.edge_count() + m_n;
+				m_range.resize(m_nthreads + 1);
+				m_range[0] = 0;
+				for (int t = 1; t < m_nthreads; t++) {
+					uint64_t goal = total * t / m_nthreads;
+					uint32_t lo = m_range[t - 1], hi = m_n;
+					while (lo < hi) {
+						uint32_t mid = lo + (hi - lo) / 2;
+						if ((uint64_t)off[mid] + mid < goal) lo = mid + 1;
+						else hi = mid;
+					}
+					m_range[t] = lo;
+				}
+				m_range[m_nthreads] = m_n;
+			}
+
+			/**
+			 * the PageRank of every vertex into rank (sums to 1), returns
+			 * the number of iterations.
+			 */
+			uint32_t run(std::vector<double> & rank, double damping = 0.85, double tol = 1e-9, uint32_t max_iter = 100) {
+				std::vector<double> teleport;
+				return iterate(rank, teleport, damping, tol, max_iter);
+			}
+
+			/**
+			 * PageRank personalized to the seeds: the random surfer jumps
+			 * back to one of them, uniformly.
+			 */
+			uint32_t run_personalized(const std::vector<uint32_t> & seeds, std::vector<double> & rank,
+					double damping = 0.85, double tol = 1e-9, uint32_t max_iter = 100) {
+				if (seeds.empty()) throw std::invalid_argument("no seed");
+				std::vector<double> teleport(m_n, 0.0);
+				for (size_t i = 0; i < seeds.size(); i++) {
+					if (seeds[i] >= m_n) throw std::out_of_range("seed out of range");
+					teleport[seeds[i]] += 1.0 / seeds.size();
+				}
+				return iterate(rank, teleport, damping, tol, max_iter);
+			}
+
+		private:
+			/**
+			 * teleport empty for the uniform one
+			 */
+			uint32_t iterate(std::vector<double> & rank, const std::vector<double> & teleport,
+					double damping, double tol, uint32_t max_iter) {
+				if (m_n == 0) {
+					rank.clear();
+					return 0;
+				}
+				if (teleport.empty()) rank.assign(m_n, 1.0 / m_n);
+				else rank = teleport;
+
+				uint32_t iter = 0;
+				while (iter < max_iter) {
+					iter++;
+					parallel(&PageRank::contributions, rank, teleport, damping, 0);
+					double dangling = 0;
+					for (int t = 0; t < m_nthreads; t++) dangling += m_partial[t];
+
+					parallel(&PageRank::pull, rank, teleport, damping, dangling);
+					double change = 0;
+					for (int t = 0; t < m_nthreads; t++) change += m_partial[t];
+					rank.swap(m_next);
+					if (change < tol) break;
+				}
+				return iter;
+			}
+
+			typedef void (PageRank::*Phase)(int, const std::vector<double> &, const std::vector<double> &, double, double);
+
+			/**
+			 * run a phase on every thread, the calling one included
+			 */
+			void parallel(Phase phase, const std::vector<double> & rank, const std::vector<double> & teleport,
+					double damping, double dangling) {
+#if __cplusplus >= 201103L
+				std::vector<std::thread> workers;
+				for (int t = 1; t < m_nthreads; t++) {
+					workers.push_back(std::thread(phase, this, t, std::cref(rank), std::cref(teleport), damping, dangling));
+				}
+				(this->*phase)(0, rank, teleport, damping, dangling);
+				for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+#else
+				(this->*phase)(0, rank, teleport, damping, dangling);
+#endif
+			}
+
+			/**
+			 * rank / outdeg of the vertices of thread t, and their dangling rank
+			 */
+			void contributions(int t, const std::vector<double> & rank, const std::vector<double> &, double, double) {
+				double dangling = 0;
+				const double * r = &rank[0], * inv = &m_inv_deg[0];
+				double * c = &m_contrib[0];
+				for (uint32_t u = m_range[t]; u < m_range[t + 1]; u++) {
+					c[u] = r[u] * inv[u];
+					dangling += inv[u] == 0.0 ? r[u] : 0.0;
+				}
+				m_partial[t] = dangling;
+			}
+
+			/**
+			 * the new rank of the vertices of thread t, and the L1 change
+			 */
+			void pull(int t, const std::vector<double> & rank, const std::vector<double> & teleport,
+					double damping, double dangling) {
+				const uint32_t * off = m_in.offsets(), * src = m_in.targets();
+				const double * c = &m_contrib[0];
+				// the share of the teleport: random jumps & dangling vertices
+				double jump = 1.0 - damping + damping * dangling;
+				double uniform = jump / m_n;
+				double change = 0;
+				for (uint32_t v = m_range[t]; v < m_range[t + 1]; v++) {
+					double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+					uint32_t f = off[v], end = off[v + 1];
+					for (; f + 4 <= end; f += 4) {
+						s0 += c[src[f]];
+						s1 += c[src[f + 1]];
+						s2 += c[src[f + 2]];
+						s3 += c[src[f + 3]];
+					}
+					for (; f < end; f++) s0 += c[src[f]];
+					double r = damping * ((s0 + s1) + (s2 + s3)) + (teleport.empty() ? uniform : jump * teleport[v]);
+					change += fabs(r - rank[v]);
+					m_next[v] = r;
+				}
+				m_partial[t] = change;
+			}
+	};
+}
+
+#endif //
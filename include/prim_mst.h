@@ -18,6 +18,15 @@
  * by Edsger Dijkstra in 1959. Therefore it is also sometimes called the DJP
  * algorithm, the Jarník algorithm, or the Prim–Jarník algorithm.
  *
+ * Variants, all over dense vertex indices with the tree returned as flat
+ * parent & weight arrays:
+ * - prim_mst: eager, an indexed 4-ary heap keeps one entry per vertex,
+ *   O(ElogV)
+ * - prim_mst_lazy: a plain binary heap of edges, stale entries are skipped
+ *   when popped, O(ElogE)
+ * - prim_mst_dense: no heap, O(V^2) scans of an adjacency matrix written
+ *   branchless so the compiler vectorizes them, best for dense graphs
+ *
  * http://en.wikipedia.org/wiki/Prim%27s_algorithm
  *
  ******************************************************************************/
@@ -27,15 +36,140 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <queue>
+#include <functional>
 #include "undirected_graph.h"
-#include "double_linked_list.h"
+#include "csr_graph.h"
+#include "2darray.h"
 #include "heap.h"
-#include "hash_table.h"
 
 namespace alg {
+	/**
+	 * parent of the root, and of the vertices not reachable from it
+	 */
+	static const uint32_t PRIM_NONE = UINT32_MAX;
+
+	/**
+	 * eager Prim, the MST of the component of `src`.
+	 * on return, {parent[v], v} is a tree edge of weight weight[v].
+	 * returns the total weight.
+	 */
+	static int64_t prim_mst(const CSRGraph & g, uint32_t src,
+			std::vector<uint32_t> & parent, std::vector<int32_t> & weight) {
+		uint32_t n = g.vertex_count();
+		parent.assign(n, PRIM_NONE);
+		weight.assign(n, 0);
+		std::vector<bool> done(n, false);
+
+		IndexedHeap<int32_t> Q(n);
+		Q.push(src, 0);
+		int64_t total = 0;
+		while (!Q.is_empty()) {
+			uint32_t u = Q.pop();
+			done[u] = true;
+			total += weight[u];
+			for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+				uint32_t v = g.target(e);
+				int32_t w = g.weight(e);
+				if (done[v]) continue;
+				if (!Q.contains(v)) {
+					Q.push(v, w);
+				} else if (w < Q.key(v)) {
+					Q.decrease_key(v, w);
+				} else {
+					continue;
+				}
+				parent[v] = u;
+				weight[v] = w;
+			}
+		}
+		return total;
+	}
+
+	/**
+	 * lazy Prim, same contract as prim_mst.
+	 */
+	static int64_t prim_mst_lazy(const CSRGraph & g, uint32_t src,
+			std::vector<uint32_t> & parent, std::vector<int32_t> & weight) {
+		uint32_t n = g.vertex_count();
+		parent.assign(n, PRIM_NONE);
+		weight.assign(n, 0);
+		std::vector<bool> done(n, false);
+
+		// (weight, (v, u)) for an edge u->v leaving the tree
+		typedef std::pair<int32_t, std::pair<uint32_t, uint32_t> > entry;
+		std::priority_queue<entry, std::vector<entry>, std::greater<entry> > Q;
+
+		int64_t total = 0;
+		done[src] = true;
+		for (uint32_t e = g.begin(src); e < g.end(src); e++) {
+			Q.push(entry(g.weight(e), std::make_pair(g.target(e), src)));
+		}
+		while (!Q.empty()) {
+			entry top = Q.top();
+			Q.pop();
+			uint32_t v = top.second.first;
+			if (done[v]) continue;		// stale
+			done[v] = true;
+			parent[v] = top.second.second;
+			weight[v] = top.first;
+			total += top.first;
+			for (uint32_t e = g.begin(v); e < g.end(v); e++) {
+				if (!done[g.target(e)]) Q.push(entry(g.weight(e), std::make_pair(g.target(e), v)));
+			}
+		}
+		return total;
+	}
+
+	/**
+	 * Prim on an n x n adjacency matrix, in O(V^2) with no heap.
+	 * w(u, v) == INT32_MAX means no edge; INT32_MIN is reserved.
+	 * same contract as prim_mst.
+	 */
+	static int64_t prim_mst_dense(const Array2D<int32_t> & w, uint32_t src,
+			std::vector<uint32_t> & parent, std::vector<int32_t> & weight) {
+		const int32_t DONE = INT32_MIN;		// no weight beats a finished vertex
+		uint32_t n = w.row();
+		parent.assign(n, PRIM_NONE);
+		weight.assign(n, 0);
+		std::vector<int32_t> key(n, INT32_MAX);
+
+		uint32_t * p = &parent[0];
+		int32_t * k = &key[0];
+		int64_t total = 0;
+		uint32_t u = src;
+		k[u] = DONE;
+		for (;;) {
+			// relax the row of u, selects instead of branches
+			const int32_t * row = w[u];
+			for (uint32_t v = 0; v < n; v++) {
+				bool better = row[v] < k[v];
+				k[v] = better ? row[v] : k[v];
+				p[v] = better ? u : p[v];
+			}
+
+			// the smallest key, mapped so that DONE goes last:
+			// INT32_MIN -> UINT32_MAX, the others keep their order
+			uint32_t best = UINT32_MAX;
+			for (uint32_t v = 0; v < n; v++) {
+				uint32_t x = ((uint32_t)k[v] ^ 0x80000000u) - 1;
+				best = x < best ? x : best;
+			}
+			if (best >= 0xfffffffeu) break;		// only INT32_MAX or DONE left
+
+			int32_t bk = (int32_t)((best + 1) ^ 0x80000000u);
+			for (u = 0; k[u] != bk; u++) {}
+			weight[u] = bk;
+			total += bk;
+			k[u] = DONE;
+		}
+		return total;
+	}
+
 	class Prim {
 		public:
-			static const int LARGE_NUMBER = 999999;
 			/**
 			 * Prim's Algorithm. 
 			 *
@@ -50,47 +184,41 @@ namespace alg {
 			 *   2. Add v to Vnew, and {u, v} to Enew
 			 *
 			 * Output: Vnew and Enew describe a minimal spanning tree
+			 *
+			 * the dense O(V^2) variant is used when at least a quarter of
+			 * the possible edges exist, the heap based one otherwise.
 			 */
 			static Graph * run(const Graph & g, int32_t src_id) {
 				UndirectedGraph * mst = new UndirectedGraph(); // empty set == Vnew
-				// weight hash table
-				HashTable<int32_t, int32_t> keys(g.vertex_count());
-				// previous vertex hash table
-				HashTable<int32_t, int32_t> pi(g.vertex_count()); 
-
-				// a binary heap
-				Heap<uint32_t> Q(g.vertex_count());
-
-				// all vertices
-				Graph::Adjacent * a;
-				list_for_each_entry(a, &g.list(), a_node){
-					Q.push(LARGE_NUMBER, a->v.id);
-					keys[a->v.id] = LARGE_NUMBER;
+				CSRGraph csr(g);
+				uint32_t n = csr.vertex_count();
+				for (uint32_t i = 0; i < n; i++) {
+					mst->add_vertex(csr.id(i));
 				}
-			
-				Q.decrease_key(src_id, 0);
-				keys[src_id] = 0;
-
-				while (!Q.is_empty()) {
-					Heap<uint32_t>::elem e = Q.pop();
-					uint32_t id = e.data;
-					Graph::Adjacent * u = g[id];	// the vertex to process
-					Graph::Vertex * v;
-					list_for_each_entry(v, &u->v_head, v_node) {
-						if (Q.contains(v->id) && v->weight < keys[v->id]) {
-							pi[v->id] = id;
-							Q.decrease_key(v->id, v->weight);
-							keys[v->id] = v->weight;
+
+				uint32_t src = csr.index_of(src_id);
+				if (src == CSRGraph::NONE) return mst;
+
+				std::vector<uint32_t> parent;
+				std::vector<int32_t> weight;
+				if ((uint64_t)csr.edge_count() * 4 >= (uint64_t)n * n) {
+					Array2D<int32_t> w(n, n);
+					w.clear(INT32_MAX);
+					for (uint32_t u = 0; u < n; u++) {
+						for (uint32_t e = csr.begin(u); e < csr.end(u); e++) {
+							int32_t & c = w(u, csr.target(e));
+							if (csr.weight(e) < c) c = csr.weight(e);
 						}
 					}
+					prim_mst_dense(w, src, parent, weight);
+				} else {
+					prim_mst(csr, src, parent, weight);
 				}
 
 				// create graph
-				list_for_each_entry(a, &g.list(), a_node){
-					mst->add_vertex(a->v.id);
-					if (pi[a->v.id] != 0) {
-						mst->add_vertex(pi[a->v.id]);
-						mst->add_edge(pi[a->v.id], a->v.id, (*a)[pi[a->v.id]]->weight);
+				for (uint32_t v = 0; v < n; v++) {
+					if (parent[v] != PRIM_NONE) {
+						mst->add_edge(csr.id(parent[v]), csr.id(v), weight[v]);
 					}
 				}
 
@@ -10,6 +10,11 @@
  * Features:
  * 1. balanced tree
  * 2. O(logn) lookup performance
+ * 3. O(logn) rank/select by subtree size
+ * 4. pluggable augmentation policy (sum, max, min ...) maintained during
+ *    rotations, giving O(logn) range aggregate queries on any key type
+ * 5. nodes are allocated from a node pool, the whole tree is freed at once
+ * 6. O(n) bulk construction from sorted input
  *
  * http://en.wikipedia.org/wiki/Red_black_tree
  * http://en.literateprograms.org/Red-black_tree_(C)
@@ -20,29 +25,111 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdexcept>
+#if __cplusplus >= 201103L
+#include <type_traits>
+#endif
 #include "rbtree_defs.h"
+#include "node_pool.h"
 
 namespace alg {
+	/**
+	 * Augmentation policies.
+	 *
+	 * A policy defines the per-subtree summary kept in each node:
+	 *   value_type			-- the summary type
+	 *   from(key, value)	-- the summary of a single node
+	 *   combine(a, b)		-- merge two summaries, must be associative
+	 *   						   and commutative
+	 */
+	template<typename KeyT, typename ValueT>
+		struct RBTreeNoAugment {
+			typedef char value_type;
+			static value_type from(const KeyT &, const ValueT &) { return 0; }
+			static value_type combine(value_type, value_type) { return 0; }
+		};
+
+	template<typename KeyT, typename ValueT>
+		struct RBTreeSum {
+			typedef ValueT value_type;
+			static value_type from(const KeyT &, const ValueT & v) { return v; }
+			static value_type combine(const value_type & a, const value_type & b) { return a + b; }
+		};
+
+	template<typename KeyT, typename ValueT>
+		struct RBTreeMax {
+			typedef ValueT value_type;
+			static value_type from(const KeyT &, const ValueT & v) { return v; }
+			static value_type combine(const value_type & a, const value_type & b) { return a < b ? b : a; }
+		};
+
 	template<typename KeyT, typename ValueT>
+		struct RBTreeMin {
+			typedef ValueT value_type;
+			static value_type from(const KeyT &, const ValueT & v) { return v; }
+			static value_type combine(const value_type & a, const value_type & b) { return b < a ? b : a; }
+		};
+
+	template<typename KeyT, typename ValueT, typename AugmentT = RBTreeNoAugment<KeyT, ValueT> >
 		class RBTree:public RBTreeAbstract {	
+			public:
+				typedef typename AugmentT::value_type aug_type;
+
 			private:
 				// a default Key-Value node.
 				struct KVNode: public rbtree_node_t {
 					KeyT key;
 					ValueT value;
+					uint32_t size;		// the size of this subtree
+					aug_type aug;		// the summary of this subtree
 				};
 
 #define KVNODE(node) static_cast<KVNode *>(node)
+#define KVNODE_SIZE(node) (node?KVNODE(node)->size:0)
+				NodePool<KVNode> m_pool;	// storage of all nodes
+
 				void destruct(KVNode * n) {
 					if (n==NULL) return;
 					destruct(KVNODE(n->left));
 					destruct(KVNODE(n->right));
-					delete n;
+					n->~KVNode();
 				}
 
 			public:
 				~RBTree() {
-					destruct(KVNODE(get_root()));
+					clear();
+				}
+
+				/**
+				 * remove all keys, the node pool is released as a whole,
+				 * node destructors only run for non-trivial key/value types.
+				 */
+				void clear() {
+#if __cplusplus >= 201103L
+					if (!std::is_trivially_destructible<KVNode>::value)
+#endif
+						destruct(KVNODE(get_root()));
+					m_pool.release();
+					set_root(NULL);
+				}
+
+				/**
+				 * replace the tree with `n` sorted, distinct keys in O(n).
+				 * the tree is perfectly balanced: every level is full except
+				 * the last one, whose nodes are colored red.
+				 */
+				void build_from_sorted(const KeyT keys[], const ValueT values[], uint32_t n) {
+					for (uint32_t i = 1; i < n; i++) {
+						if (!(keys[i-1] < keys[i]))
+							throw std::invalid_argument ("keys are not sorted or not unique");
+					}
+
+					clear();
+					m_pool.reserve(n);
+
+					// number of full levels
+					int full = 0;
+					while (((uint64_t)2 << full) - 1 <= n) full++;
+					set_root(build_helper(keys, values, 0, (int64_t)n - 1, 0, full));
 				}
 
 				/**
@@ -59,7 +146,8 @@ namespace alg {
 							if (key == n->key) {
 								n->value = value;
 								/* inserted_node isn't going to be used, don't leak it */
-								delete (inserted_node);
+								free_node(inserted_node);
+								fixup_path(n);
 								return;
 							} else if (key < n->key) {
 								if (n->left == NULL) {
@@ -79,6 +167,7 @@ namespace alg {
 							}
 						}
 						inserted_node->parent = n;
+						fixup_path(n);
 					}
 					insert_case1(inserted_node);
 				}
@@ -127,7 +216,94 @@ namespace alg {
 
 	    			if (n->parent == NULL && child != NULL)	// root
         				child->color = BLACK;
-					delete(n);
+					// every ancestor of the removed node lost it from its summary
+					fixup_path(n->parent);
+					free_node(n);
+				}
+
+				/**
+				 * the number of keys in the tree
+				 */
+				uint32_t size() {
+					return KVNODE_SIZE(get_root());
+				}
+
+				/**
+				 * the number of keys strictly less than `key`
+				 */
+				uint32_t rank(const KeyT & key) {
+					uint32_t r = 0;
+					KVNode * n = KVNODE(get_root());
+					while (n != NULL) {
+						if (n->key < key) {
+							r += KVNODE_SIZE(n->left) + 1;
+							n = KVNODE(n->right);
+						} else {
+							n = KVNODE(n->left);
+						}
+					}
+					return r;
+				}
+
+				/**
+				 * select the i-th smallest key, starting from 0
+				 */
+				const KeyT & select(uint32_t i) {
+					if (i >= size()) throw std::out_of_range ("rank out of range");
+					KVNode * n = KVNODE(get_root());
+					while (1) {
+						uint32_t lsize = KVNODE_SIZE(n->left);
+						if (i == lsize) return n->key;
+						if (i < lsize) {
+							n = KVNODE(n->left);
+						} else {
+							i -= lsize + 1;
+							n = KVNODE(n->right);
+						}
+					}
+				}
+
+				/**
+				 * combine the summaries of all keys in [low, high].
+				 * returns false if there is no key in range.
+				 */
+				bool aggregate(const KeyT & low, const KeyT & high, aug_type & out) {
+					// find the split node where the paths to low & high diverge
+					KVNode * n = KVNODE(get_root());
+					while (n != NULL) {
+						if (n->key < low) n = KVNODE(n->right);
+						else if (high < n->key) n = KVNODE(n->left);
+						else break;
+					}
+					if (n == NULL) return false;
+
+					bool found = true;
+					out = AugmentT::from(n->key, n->value);
+
+					// left spine: keys >= low
+					KVNode * x = KVNODE(n->left);
+					while (x != NULL) {
+						if (x->key < low) {
+							x = KVNODE(x->right);
+						} else {
+							accumulate(found, out, AugmentT::from(x->key, x->value));
+							if (x->right != NULL) accumulate(found, out, KVNODE(x->right)->aug);
+							x = KVNODE(x->left);
+						}
+					}
+
+					// right spine: keys <= high
+					x = KVNODE(n->right);
+					while (x != NULL) {
+						if (high < x->key) {
+							x = KVNODE(x->left);
+						} else {
+							accumulate(found, out, AugmentT::from(x->key, x->value));
+							if (x->left != NULL) accumulate(found, out, KVNODE(x->left)->aug);
+							x = KVNODE(x->right);
+						}
+					}
+					return found;
 				}
 
 				void print() {
@@ -156,9 +332,11 @@ namespace alg {
 				}
 
 				KVNode * new_node(KeyT key, ValueT value, color rbtree_node_color, rbtree_node left, rbtree_node right) {
-					KVNode * result =new KVNode;
+					KVNode * result = new (m_pool.alloc()) KVNode;
 					result->key = key;
 					result->value = value;
+					result->size = 1;
+					result->aug = AugmentT::from(key, value);
 					result->color = rbtree_node_color;
 					result->left = left;
 					result->right = right;
@@ -168,6 +346,58 @@ namespace alg {
 					return result;
 				}
 
+				void free_node(KVNode * n) {
+					n->~KVNode();
+					m_pool.free(n);
+				}
+
+				/**
+				 * build the subtree of keys[lo..hi] rooted at `depth`
+				 */
+				KVNode * build_helper(const KeyT keys[], const ValueT values[], int64_t lo, int64_t hi, int depth, int full) {
+					if (lo > hi) return NULL;
+					int64_t mid = lo + (hi - lo) / 2;
+					KVNode * n = new_node(keys[mid], values[mid], depth < full ? BLACK : RED,
+							build_helper(keys, values, lo, mid - 1, depth + 1, full),
+							build_helper(keys, values, mid + 1, hi, depth + 1, full));
+					pull(n);
+					return n;
+				}
+
+				/**
+				 * recompute size & summary of a node from its children
+				 */
+				void pull(KVNode * n) {
+					n->size = KVNODE_SIZE(n->left) + KVNODE_SIZE(n->right) + 1;
+					n->aug = AugmentT::from(n->key, n->value);
+					if (n->left != NULL) n->aug = AugmentT::combine(KVNODE(n->left)->aug, n->aug);
+					if (n->right != NULL) n->aug = AugmentT::combine(n->aug, KVNODE(n->right)->aug);
+				}
+
+				void fixup_path(rbtree_node n) {
+					for (; n != NULL; n = n->parent) {
+						pull(KVNODE(n));
+					}
+				}
+
+				static void accumulate(bool & found, aug_type & out, const aug_type & v) {
+					out = found ? AugmentT::combine(out, v) : v;
+					found = true;
+				}
+
+				/**
+				 * left/right rotation call back function,
+				 * n is now the child of parent.
+				 */
+				void rotate_left_callback(rbtree_node n, rbtree_node parent) {
+					pull(KVNODE(n));
+					pull(KVNODE(parent));
+				}
+
+				void rotate_right_callback(rbtree_node n, rbtree_node parent) {
+					rotate_left_callback(n, parent);
+				}
+
 				KVNode * lookup_node(KeyT key) {
 					KVNode * n = KVNODE(get_root());
 					while (n != NULL) {
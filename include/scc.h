@@ -14,7 +14,24 @@
  * strong connectivity of a graph, or to find its strongly connected components,
  * in linear time.
  *
+ * Implementations, over a CSRGraph, returning comp[v] = component id:
+ * - tarjan_scc: Tarjan's algorithm with an explicit stack, no recursion,
+ *   O(V + E). components are numbered in reverse topological order.
+ * - parallel_scc (C++11): multithreaded,
+ *   1. trim: vertices without alive in- or out-edges are single components,
+ *      removed in cascade with atomic degree counters
+ *   2. forward-backward: the vertices both reachable from & reaching a
+ *      pivot form its component, found by a parallel search; usually the
+ *      giant component
+ *   3. coloring: the max vertex id is propagated along the edges, every
+ *      vertex keeping its own id is a root, and its component is the set of
+ *      the same color reaching it. repeated on what is left.
+ *   long chains that make the coloring slow are finished by Tarjan.
+ *
  * http://en.wikipedia.org/wiki/Strongly_connected_component
+ * http://en.wikipedia.org/wiki/Tarjan%27s_strongly_connected_components_algorithm
+ * Hong, Rodia & Olukotun, On Fast Parallel Detection of Strongly Connected
+ * Components (SCC) in Small-World Graphs, 2013
  ******************************************************************************/
 
 #ifndef ALGO_SCC_H__
@@ -22,45 +39,334 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <limits.h>
+#include <vector>
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#endif
 #include "graph_defs.h"
-#include "graph_search.h"
-#include "heap.h"
+#include "directed_graph.h"
+#include "csr_graph.h"
 
 namespace alg {
+	static const uint32_t SCC_NONE = UINT32_MAX;
+
+	namespace detail {
+		/**
+		 * Tarjan over the vertices with comp[v] == SCC_NONE, the others are
+		 * treated as finished. new components are numbered from `next`.
+		 */
+		static uint32_t tarjan(const CSRGraph & g, std::vector<uint32_t> & comp, uint32_t next) {
+			uint32_t n = g.vertex_count();
+			std::vector<uint32_t> index(n, SCC_NONE);
+			std::vector<uint32_t> low(n);
+			std::vector<uint32_t> it(n);		// next edge to explore
+			std::vector<uint32_t> stack;		// Tarjan's stack
+			std::vector<uint32_t> call;			// the DFS path
+			uint32_t counter = 0;
+
+			for (uint32_t s = 0; s < n; s++) {
+				if (comp[s] != SCC_NONE || index[s] != SCC_NONE) continue;
+
+				index[s] = low[s] = counter++;
+				it[s] = g.begin(s);
+				stack.push_back(s);
+				call.push_back(s);
+				while (!call.empty()) {
+					uint32_t v = call.back();
+					if (it[v] < g.end(v)) {
+						uint32_t w = g.target(it[v]++);
+						if (comp[w] != SCC_NONE) continue;	// in a finished component
+						if (index[w] == SCC_NONE) {
+							index[w] = low[w] = counter++;
+							it[w] = g.begin(w);
+							stack.push_back(w);
+							call.push_back(w);
+						} else if (index[w] < low[v]) {		// on the stack
+							low[v] = index[w];
+						}
+						continue;
+					}
+
+					call.pop_back();
+					if (!call.empty() && low[v] < low[call.back()]) low[call.back()] = low[v];
+					if (low[v] == index[v]) {	// v is the root of a component
+						uint32_t w;
+						do {
+							w = stack.back();
+							stack.pop_back();
+							comp[w] = next;
+						} while (w != v);
+						next++;
+					}
+				}
+			}
+			return next;
+		}
+	}
+
 	/**
-	 * Output Strongly Connected Component of a Graph
+	 * Tarjan's SCC, comp[v] is the component of v.
+	 * returns the number of components.
 	 */
-	static void SCC(DirectedGraph &g) {
-		// call DFS(G) to compute finishing times u.f for each vertex u
-		DFS(g);
-		// the transpose of the graph
-		DirectedGraph * GT = g.transpose();
-		// step 1. discover vertices of G in decreasing of u.f
-		Heap<int32_t> Q(g.vertex_count()) ;
-		Graph::Adjacent * a;
-		list_for_each_entry(a, &g.list(), a_node) {
-			Q.push(INT_MAX - a->f, a->v.id);	// descending order of a->f
+	static uint32_t tarjan_scc(const CSRGraph & g, std::vector<uint32_t> & comp) {
+		comp.assign(g.vertex_count(), SCC_NONE);
+		return detail::tarjan(g, comp, 0);
+	}
+
+#if __cplusplus >= 201103L
+	namespace detail {
+		/**
+		 * run f(tid) on nthreads threads
+		 */
+		template<typename F>
+		static void scc_run(int nthreads, F f) {
+			std::vector<std::thread> workers;
+			for (int t = 1; t < nthreads; t++) workers.push_back(std::thread(f, t));
+			f(0);
+			for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+		}
+
+		/**
+		 * mark seen[v] for every vertex reachable from src without passing
+		 * a removed one. each thread explores depth-first from a local
+		 * stack, and hands half of it over when another thread is idle.
+		 */
+		static void parallel_reach(const CSRGraph & g, uint32_t src,
+				const std::atomic<uint8_t> * removed, std::atomic<uint8_t> * seen, int nthreads) {
+			const size_t GRAIN = 256;
+			std::mutex mu;
+			std::condition_variable cv;
+			std::vector<uint32_t> shared(1, src);
+			std::atomic<int> idle(0);
+			bool done = false;
+			seen[src].store(1, std::memory_order_relaxed);
+
+			scc_run(nthreads, [&](int) {
+				std::vector<uint32_t> local;
+				for (;;) {
+					if (local.empty()) {
+						std::unique_lock<std::mutex> lk(mu);
+						idle++;
+						while (shared.empty() && !done) {
+							if (idle == nthreads) {
+								done = true;
+								cv.notify_all();
+								break;
+							}
+							cv.wait(lk);
+						}
+						if (done) return;
+						idle--;
+						size_t take = std::min(shared.size(), GRAIN);
+						local.assign(shared.end() - take, shared.end());
+						shared.resize(shared.size() - take);
+					}
+
+					uint32_t v = local.back();
+					local.pop_back();
+					for (uint32_t e = g.begin(v); e < g.end(v); e++) {
+						uint32_t w = g.target(e);
+						if (removed[w].load(std::memory_order_relaxed)) continue;
+						if (seen[w].load(std::memory_order_relaxed)) continue;
+						if (seen[w].exchange(1, std::memory_order_relaxed) == 0) local.push_back(w);
+					}
+
+					if (local.size() > GRAIN && idle.load(std::memory_order_relaxed) > 0) {
+						std::lock_guard<std::mutex> lk(mu);
+						size_t give = local.size() / 2;
+						shared.insert(shared.end(), local.end() - give, local.end());
+						local.resize(local.size() - give);
+						cv.notify_all();
+					}
+				}
+			});
+		}
+	}
+
+	/**
+	 * multithreaded SCC, same contract as tarjan_scc. the component ids
+	 * are dense, but in no particular order.
+	 */
+	static uint32_t parallel_scc(const CSRGraph & g, std::vector<uint32_t> & comp, int nthreads = 0) {
+		const int MAX_COLOR_ROUNDS = 64;		// then finish by Tarjan
+		const uint32_t SMALL = 4096;			// left for Tarjan as well
+
+		if (nthreads <= 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+		uint32_t n = g.vertex_count();
+		comp.assign(n, SCC_NONE);
+		if (n == 0) return 0;
+
+		CSRGraph gt = g.transpose();
+		std::unique_ptr<std::atomic<uint8_t>[]> removed(new std::atomic<uint8_t>[n]);
+		std::unique_ptr<std::atomic<uint32_t>[]> indeg(new std::atomic<uint32_t>[n]);
+		std::unique_ptr<std::atomic<uint32_t>[]> outdeg(new std::atomic<uint32_t>[n]);
+		for (uint32_t v = 0; v < n; v++) {
+			removed[v].store(0, std::memory_order_relaxed);
+			indeg[v].store(gt.degree(v), std::memory_order_relaxed);
+			outdeg[v].store(g.degree(v), std::memory_order_relaxed);
 		}
+		std::atomic<uint32_t> next(0);
+		std::atomic<uint32_t> alive(n);
 
-		// step 2. discover 
-		// mark all vertex color to WHITE   
-		list_for_each_entry(a, &GT->list(), a_node) {
-			a->color = Graph::WHITE;
+		// 1. trim, a removed vertex lowers the degrees of its neighbours,
+		// whoever drops one to 0 removes it as well.
+		detail::scc_run(nthreads, [&](int t) {
+			std::vector<uint32_t> work;
+			uint32_t begin = (uint64_t)n * t / nthreads, end = (uint64_t)n * (t + 1) / nthreads;
+			for (uint32_t s = begin; s < end; s++) {
+				if (indeg[s].load(std::memory_order_relaxed) != 0 &&
+					outdeg[s].load(std::memory_order_relaxed) != 0) continue;
+				work.push_back(s);
+				while (!work.empty()) {
+					uint32_t v = work.back();
+					work.pop_back();
+					uint8_t expect = 0;
+					if (!removed[v].compare_exchange_strong(expect, 1)) continue;
+					comp[v] = next++;
+					alive--;
+					for (uint32_t e = g.begin(v); e < g.end(v); e++) {
+						uint32_t w = g.target(e);
+						if (indeg[w].fetch_sub(1) == 1 && !removed[w].load()) work.push_back(w);
+					}
+					for (uint32_t e = gt.begin(v); e < gt.end(v); e++) {
+						uint32_t w = gt.target(e);
+						if (outdeg[w].fetch_sub(1) == 1 && !removed[w].load()) work.push_back(w);
+					}
+				}
+			}
+		});
+
+		// 2. forward-backward from the vertex with the most paths through it
+		if (alive > SMALL) {
+			uint32_t pivot = SCC_NONE;
+			uint64_t best = 0;
+			for (uint32_t v = 0; v < n; v++) {
+				if (removed[v].load(std::memory_order_relaxed)) continue;
+				uint64_t d = (uint64_t)indeg[v].load(std::memory_order_relaxed) * outdeg[v].load(std::memory_order_relaxed);
+				if (pivot == SCC_NONE || d > best) { pivot = v; best = d; }
+			}
+
+			std::unique_ptr<std::atomic<uint8_t>[]> fw(new std::atomic<uint8_t>[n]);
+			std::unique_ptr<std::atomic<uint8_t>[]> bw(new std::atomic<uint8_t>[n]);
+			for (uint32_t v = 0; v < n; v++) {
+				fw[v].store(0, std::memory_order_relaxed);
+				bw[v].store(0, std::memory_order_relaxed);
+			}
+			detail::parallel_reach(g, pivot, removed.get(), fw.get(), nthreads);
+			detail::parallel_reach(gt, pivot, removed.get(), bw.get(), nthreads);
+
+			uint32_t id = next++;
+			for (uint32_t v = 0; v < n; v++) {
+				if (fw[v].load(std::memory_order_relaxed) && bw[v].load(std::memory_order_relaxed)) {
+					comp[v] = id;
+					removed[v].store(1, std::memory_order_relaxed);
+					alive--;
+				}
+			}
 		}
 
-		// step 3. call DFS(GT), but in the main loop of DFS, consider the vertices
-		// in order of decreasing u.f (as computed in line 1)
-		while(!Q.is_empty()) {
-			Heap<int32_t>::elem e = Q.pop();
-			int32_t key = e.key;
-			int32_t id = e.data;
-			if ((*GT)[id]->color == Graph::WHITE) {
-				printf("component:%d %d\n",id, INT_MAX - key);
-				_DFS_VISIT(*GT, (*GT)[id]);
-				printf("\n");
+		// 3. coloring
+		std::unique_ptr<std::atomic<uint32_t>[]> color(new std::atomic<uint32_t>[n]);
+		while (alive > SMALL) {
+			for (uint32_t v = 0; v < n; v++) color[v].store(v, std::memory_order_relaxed);
+
+			// propagate the max color forward until stable
+			bool stable = false;
+			for (int round = 0; round < MAX_COLOR_ROUNDS && !stable; round++) {
+				std::atomic<bool> changed(false);
+				detail::scc_run(nthreads, [&](int t) {
+					uint32_t begin = (uint64_t)n * t / nthreads, end = (uint64_t)n * (t + 1) / nthreads;
+					bool local = false;
+					for (uint32_t v = begin; v < end; v++) {
+						if (removed[v].load(std::memory_order_relaxed)) continue;
+						uint32_t c = color[v].load(std::memory_order_relaxed);
+						for (uint32_t e = g.begin(v); e < g.end(v); e++) {
+							uint32_t w = g.target(e);
+							if (removed[w].load(std::memory_order_relaxed)) continue;
+							uint32_t cur = color[w].load(std::memory_order_relaxed);
+							while (cur < c) {
+								if (color[w].compare_exchange_weak(cur, c, std::memory_order_relaxed)) {
+									local = true;
+									break;
+								}
+							}
+						}
+					}
+					if (local) changed.store(true, std::memory_order_relaxed);
+				});
+				stable = !changed.load();
 			}
+			if (!stable) break;
+
+			// each root collects the vertices of its color reaching it,
+			// the colors are disjoint so the roots run independently
+			std::atomic<uint32_t> cursor(0);
+			detail::scc_run(nthreads, [&](int) {
+				std::vector<uint32_t> stack;
+				std::vector<uint32_t> members;
+				for (;;) {
+					uint32_t r = cursor.fetch_add(1024);
+					if (r >= n) return;
+					uint32_t rend = std::min(n, r + 1024);
+					for (; r < rend; r++) {
+						if (removed[r].load(std::memory_order_relaxed) ||
+							color[r].load(std::memory_order_relaxed) != r) continue;
+						uint32_t id = next++;
+						members.assign(1, r);
+						stack.assign(1, r);
+						comp[r] = id;
+						while (!stack.empty()) {
+							uint32_t v = stack.back();
+							stack.pop_back();
+							for (uint32_t e = gt.begin(v); e < gt.end(v); e++) {
+								uint32_t w = gt.target(e);
+								if (removed[w].load(std::memory_order_relaxed) ||
+									color[w].load(std::memory_order_relaxed) != r || comp[w] == id) continue;
+								comp[w] = id;
+								members.push_back(w);
+								stack.push_back(w);
+							}
+						}
+						// removed only now, the other roots never look at color r
+						for (size_t i = 0; i < members.size(); i++) {
+							removed[members[i]].store(1, std::memory_order_relaxed);
+						}
+						alive -= (uint32_t)members.size();
+					}
+				}
+			});
+		}
+
+		// what is left
+		return detail::tarjan(g, comp, next);
+	}
+#endif
+
+	/**
+	 * Output Strongly Connected Component of a Graph
+	 */
+	static void SCC(DirectedGraph &g) {
+		CSRGraph csr(g);
+		std::vector<uint32_t> comp;
+		uint32_t k = tarjan_scc(csr, comp);
+
+		// group the vertices by component, in topological order
+		std::vector<uint32_t> start(k + 1, 0);
+		for (uint32_t v = 0; v < csr.vertex_count(); v++) start[comp[v] + 1]++;
+		for (uint32_t c = 0; c < k; c++) start[c + 1] += start[c];
+		std::vector<uint32_t> members(csr.vertex_count());
+		for (uint32_t v = 0; v < csr.vertex_count(); v++) members[start[comp[v]]++] = v;
+
+		for (uint32_t c = k; c-- > 0;) {
+			uint32_t begin = c == 0 ? 0 : start[c - 1];	// start[c] is now the end of c
+			printf("component:%d", k - 1 - c);
+			for (uint32_t i = begin; i < start[c]; i++) printf(" %d", csr.id(members[i]));
+			printf("\n");
 		}
-		delete GT;
 	}
 }
 
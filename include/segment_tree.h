@@ -0,0 +1,303 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * SEGMENT TREE
+ *
+ * Features:
+ * 1. array based, no recursion, positions are 0-based, ranges half-open [l, r)
+ * 2. SegmentTree: bottom-up tree for point update & range query in O(logn)
+ * 3. LazySegmentTree: range update & range query in O(logn) with lazy
+ *    propagation, still iterative
+ * 4. pluggable monoid (sum, min, max ...) and lazy action (add, assign ...)
+ *
+ * A monoid policy defines:
+ *   value_type			-- the element type
+ *   e()				-- the identity, op(e(), x) == x
+ *   op(a, b)			-- associative combine, need not be commutative
+ *
+ * A lazy policy is a monoid policy plus:
+ *   lazy_type			-- the pending update
+ *   id()				-- the update doing nothing
+ *   mapping(f, x, len)	-- apply update f to a segment of `len` elements
+ *   						   whose combined value is x
+ *   composition(f, g)	-- the update doing g first, then f
+ *
+ * http://en.wikipedia.org/wiki/Segment_tree
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_SEGMENT_TREE_H__
+#define ALGO_SEGMENT_TREE_H__
+#include <stdint.h>
+#include <vector>
+#include <limits>
+
+namespace alg {
+	/**
+	 * monoids
+	 */
+	template<typename T>
+		struct SegSum {
+			typedef T value_type;
+			static T e() { return T(); }
+			static T op(const T & a, const T & b) { return a + b; }
+		};
+
+	template<typename T>
+		struct SegMin {
+			typedef T value_type;
+			static T e() { return std::numeric_limits<T>::max(); }
+			static T op(const T & a, const T & b) { return b < a ? b : a; }
+		};
+
+	template<typename T>
+		struct SegMax {
+			typedef T value_type;
+			static T e() {
+				return std::numeric_limits<T>::is_integer ?
+					std::numeric_limits<T>::min() : -std::numeric_limits<T>::max();
+			}
+			static T op(const T & a, const T & b) { return a < b ? b : a; }
+		};
+
+	/**
+	 * lazy actions: add a constant to a range
+	 */
+	template<typename T>
+		struct RangeAddSum : public SegSum<T> {
+			typedef T lazy_type;
+			static T id() { return T(); }
+			static T mapping(const T & f, const T & x, int len) { return x + f * len; }
+			static T composition(const T & f, const T & g) { return f + g; }
+		};
+
+	template<typename T>
+		struct RangeAddMin : public SegMin<T> {
+			typedef T lazy_type;
+			static T id() { return T(); }
+			static T mapping(const T & f, const T & x, int) { return x + f; }
+			static T composition(const T & f, const T & g) { return f + g; }
+		};
+
+	template<typename T>
+		struct RangeAddMax : public SegMax<T> {
+			typedef T lazy_type;
+			static T id() { return T(); }
+			static T mapping(const T & f, const T & x, int) { return x + f; }
+			static T composition(const T & f, const T & g) { return f + g; }
+		};
+
+	/**
+	 * lazy actions: assign a constant to a range
+	 */
+	template<typename T>
+		struct SegAssign {
+			bool set;
+			T v;
+		};
+
+	template<typename T>
+		struct RangeAssignSum : public SegSum<T> {
+			typedef SegAssign<T> lazy_type;
+			static lazy_type id() { lazy_type f; f.set = false; f.v = T(); return f; }
+			static T mapping(const lazy_type & f, const T & x, int len) { return f.set ? f.v * len : x; }
+			static lazy_type composition(const lazy_type & f, const lazy_type & g) { return f.set ? f : g; }
+		};
+
+	template<typename T>
+		struct RangeAssignMin : public SegMin<T> {
+			typedef SegAssign<T> lazy_type;
+			static lazy_type id() { lazy_type f; f.set = false; f.v = T(); return f; }
+			static T mapping(const lazy_type & f, const T & x, int) { return f.set ? f.v : x; }
+			static lazy_type composition(const lazy_type & f, const lazy_type & g) { return f.set ? f : g; }
+		};
+
+	template<typename T>
+		struct RangeAssignMax : public SegMax<T> {
+			typedef SegAssign<T> lazy_type;
+			static lazy_type id() { lazy_type f; f.set = false; f.v = T(); return f; }
+			static T mapping(const lazy_type & f, const T & x, int) { return f.set ? f.v : x; }
+			static lazy_type composition(const lazy_type & f, const lazy_type & g) { return f.set ? f : g; }
+		};
+
+	/**
+	 * bottom-up segment tree, the leaves are d[n..2n), node k covers
+	 * its children 2k and 2k+1.
+	 */
+	template<typename Monoid>
+		class SegmentTree {
+			public:
+				typedef typename Monoid::value_type value_type;
+			private:
+				int n;
+				std::vector<value_type> d;
+
+			public:
+				explicit SegmentTree(int n) : n(n), d(2 * n, Monoid::e()) {}
+
+				/**
+				 * build from a[0..n-1] in O(n)
+				 */
+				SegmentTree(const value_type a[], int n) : n(n), d(2 * n, Monoid::e()) {
+					for (int i = 0; i < n; i++) d[n + i] = a[i];
+					for (int i = n - 1; i > 0; i--) d[i] = Monoid::op(d[2 * i], d[2 * i + 1]);
+				}
+
+				int size() const { return n; }
+
+				/**
+				 * a[p] = x
+				 */
+				void set(int p, const value_type & x) {
+					p += n;
+					d[p] = x;
+					for (p >>= 1; p > 0; p >>= 1) d[p] = Monoid::op(d[2 * p], d[2 * p + 1]);
+				}
+
+				const value_type & get(int p) const { return d[p + n]; }
+
+				/**
+				 * op(a[l], ..., a[r-1]), e() for an empty range
+				 */
+				value_type query(int l, int r) const {
+					value_type sl = Monoid::e(), sr = Monoid::e();
+					for (l += n, r += n; l < r; l >>= 1, r >>= 1) {
+						if (l & 1) sl = Monoid::op(sl, d[l++]);
+						if (r & 1) sr = Monoid::op(d[--r], sr);
+					}
+					return Monoid::op(sl, sr);
+				}
+		};
+
+	/**
+	 * iterative segment tree with lazy propagation,
+	 * over a power-of-2 number of leaves d[size..2size).
+	 */
+	template<typename Policy>
+		class LazySegmentTree {
+			public:
+				typedef typename Policy::value_type value_type;
+				typedef typename Policy::lazy_type lazy_type;
+			private:
+				int n, size, log;
+				std::vector<value_type> d;
+				std::vector<lazy_type> lz;
+
+			public:
+				explicit LazySegmentTree(int n) : n(n) {
+					init();
+					for (int i = size - 1; i > 0; i--) pull(i);
+				}
+
+				/**
+				 * build from a[0..n-1] in O(n)
+				 */
+				LazySegmentTree(const value_type a[], int n) : n(n) {
+					init();
+					for (int i = 0; i < n; i++) d[size + i] = a[i];
+					for (int i = size - 1; i > 0; i--) pull(i);
+				}
+
+				int length() const { return n; }
+
+				void set(int p, const value_type & x) {
+					p += size;
+					for (int i = log; i >= 1; i--) push(p >> i);
+					d[p] = x;
+					for (int i = 1; i <= log; i++) pull(p >> i);
+				}
+
+				value_type get(int p) {
+					p += size;
+					for (int i = log; i >= 1; i--) push(p >> i);
+					return d[p];
+				}
+
+				/**
+				 * op(a[l], ..., a[r-1]), e() for an empty range
+				 */
+				value_type query(int l, int r) {
+					if (l == r) return Policy::e();
+					l += size;
+					r += size;
+					push_bounds(l, r);
+
+					value_type sl = Policy::e(), sr = Policy::e();
+					for (; l < r; l >>= 1, r >>= 1) {
+						if (l & 1) sl = Policy::op(sl, d[l++]);
+						if (r & 1) sr = Policy::op(d[--r], sr);
+					}
+					return Policy::op(sl, sr);
+				}
+
+				/**
+				 * apply f to a[l], ..., a[r-1]
+				 */
+				void apply(int l, int r, const lazy_type & f) {
+					if (l == r) return;
+					l += size;
+					r += size;
+					push_bounds(l, r);
+
+					int l2 = l, r2 = r;
+					for (; l < r; l >>= 1, r >>= 1) {
+						if (l & 1) all_apply(l++, f);
+						if (r & 1) all_apply(--r, f);
+					}
+					l = l2;
+					r = r2;
+
+					for (int i = 1; i <= log; i++) {
+						if (((l >> i) << i) != l) pull(l >> i);
+						if (((r >> i) << i) != r) pull((r - 1) >> i);
+					}
+				}
+
+			private:
+				void init() {
+					log = 0;
+					while ((1 << log) < n) log++;
+					size = 1 << log;
+					d.assign(2 * size, Policy::e());
+					lz.assign(size, Policy::id());
+				}
+
+				// number of leaves under node k
+				int node_len(int k) const {
+#if defined(__GNUC__) || defined(__clang__)
+					int depth = 31 - __builtin_clz((unsigned)k);
+#else
+					int depth = 0;
+					while ((k >> depth) > 1) depth++;
+#endif
+					return size >> depth;
+				}
+
+				void pull(int k) { d[k] = Policy::op(d[2 * k], d[2 * k + 1]); }
+
+				void all_apply(int k, const lazy_type & f) {
+					d[k] = Policy::mapping(f, d[k], node_len(k));
+					if (k < size) lz[k] = Policy::composition(f, lz[k]);
+				}
+
+				void push(int k) {
+					all_apply(2 * k, lz[k]);
+					all_apply(2 * k + 1, lz[k]);
+					lz[k] = Policy::id();
+				}
+
+				// push down the pending updates of the nodes above the boundaries
+				void push_bounds(int l, int r) {
+					for (int i = log; i >= 1; i--) {
+						if (((l >> i) << i) != l) push(l >> i);
+						if (((r >> i) << i) != r) push((r - 1) >> i);
+					}
+				}
+		};
+}
+
+#endif //
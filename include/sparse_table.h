@@ -0,0 +1,92 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * SPARSE TABLE
+ *
+ * Features:
+ * 1. static range minimum query (RMQ) in O(1) after O(nlogn) preprocessing
+ * 2. the levels are stored back to back in one flat array
+ * 3. any idempotent selection by a comparator (min, max ...)
+ *
+ * level k holds the minimum of every window of 2^k elements, a query [l, r)
+ * is answered by the two overlapping windows covering it.
+ *
+ * http://en.wikipedia.org/wiki/Range_minimum_query
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_SPARSE_TABLE_H__
+#define ALGO_SPARSE_TABLE_H__
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <functional>
+
+namespace alg {
+	template<typename T, typename Compare = std::less<T> >
+	class SparseTable {
+	private:
+		int m_n;
+		int m_levels;
+		std::vector<T> m_table;		// m_table[k * n + i] = min(a[i .. i+2^k))
+		Compare m_less;
+
+	public:
+		SparseTable() : m_n(0), m_levels(0) {}
+
+		SparseTable(const T a[], int n) {
+			build(a, n);
+		}
+
+		/**
+		 * (re)build over a[0..n-1]
+		 */
+		void build(const T a[], int n) {
+			m_n = n;
+			m_levels = n > 0 ? floor_log2(n) + 1 : 0;
+			m_table.resize((size_t)m_levels * n);
+
+			for (int i = 0; i < n; i++) m_table[i] = a[i];
+			for (int k = 1; k < m_levels; k++) {
+				const T * prev = &m_table[(size_t)(k - 1) * n];
+				T * cur = &m_table[(size_t)k * n];
+				int half = 1 << (k - 1);
+				for (int i = 0; i + (1 << k) <= n; i++) {
+					cur[i] = select(prev[i], prev[i + half]);
+				}
+			}
+		}
+
+		int size() const { return m_n; }
+
+		/**
+		 * the minimum of a[l .. r), the range must not be empty
+		 */
+		const T & query(int l, int r) const {
+			int k = floor_log2(r - l);
+			const T * row = &m_table[(size_t)k * m_n];
+			return select(row[l], row[r - (1 << k)]);
+		}
+
+		static inline int floor_log2(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+			return 31 - __builtin_clz(x);
+#else
+			int k = 0;
+			while (x >>= 1) k++;
+			return k;
+#endif
+		}
+
+	private:
+		inline const T & select(const T & a, const T & b) const {
+			return m_less(b, a) ? b : a;
+		}
+	};
+}
+
+#endif //
@@ -1,21 +1,33 @@
 /*******************************************************************************
  * ALGORITHM IMPLEMENTAIONS
  *
- *  /\  |  _   _  ._ o _|_ |_  ._ _   _ 
- * /--\ | (_| (_) |  |  |_ | | | | | _> 
- *         _|                      
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
  *
  * SUFFIX ARRAY
  *
- * Features: 
- * suffix array can sort all the suffixs in time complexity O(n*log^2(n)), 
- * and use memory in O(n).  And suffix array can get two suffixs' longest 
- * common prefix(lcp) in O(log(n)) complexity. 
+ * Features:
+ * suffix array sorts all the suffixs of a byte string in O(n) time by
+ * SA-IS (induced sorting), any byte value allowed, embedded zeros included.
+ * the LCP array (lcp of two neighbour suffixs in the sorted order) follows
+ * in O(n) by Kasai's algorithm, and the longest common prefix of any two
+ * suffixs in O(1) by a range minimum over it.
+ *
+ * sais() & kasai() work on raw arrays, the index type picks the size:
+ * uint32_t up to 4GB of text, 4 bytes per entry, uint64_t beyond. sais()
+ * needs little beyond the array: a bit per char & the buckets, the
+ * reduced problem is solved inside the array.
+ * SuffixArray keeps the array, the ranks & the LCP of a string.
  *
  * You can test it by running suffix_array_demo.cpp
- * Want to get more detailed information about suffix array? 
+ * Want to get more detailed information about suffix array?
  *
  * Please google SUFF_AR_ENG.pdf
+ * Nong, Zhang & Chan, Two Efficient Algorithms for Linear Time Suffix Array
+ * Construction, 2011
+ * Kasai et al., Linear-Time Longest-Common-Prefix Computation in Suffix
+ * Arrays and Its Applications, 2001
  *
  * AUTHOR: nowerzt@gmail.com
  ******************************************************************************/
@@ -23,80 +35,273 @@
 #ifndef ALGO_SUFFIX_ARRAY_H__
 #define ALGO_SUFFIX_ARRAY_H__
 
+#include <stdint.h>
 #include <algorithm>
 #include <vector>
 #include <string>
+#include <stdexcept>
 #include <math.h>
 #include <functional>
 
 using namespace std;
 
 namespace alg {
-	class SuffixArray {
-		private:
-			vector<vector<int> > bucket;
-			vector<int> suffix;
-			int N, L, K;
-			const string& str;
-			void suffix_sort();
-			void update_bucket();
-
-			bool less_than(int a, int b) { 
-				if(K==0) return str[a]<str[b];
-				else {
-					if(bucket[K-1][a]==bucket[K-1][b]) return bucket[K-1][a+L/2]<bucket[K-1][b+L/2];
-					else return bucket[K-1][a]<bucket[K-1][b];
+	namespace detail {
+		/**
+		 * i starts an LMS suffix: S type after an L type
+		 */
+		template<typename IndexT>
+		static inline bool sais_lms(const vector<bool> & ls, IndexT i) {
+			return i > 0 && ls[i] && !ls[i - 1];
+		}
+
+		/**
+		 * the start (or the end) of the bucket of every char
+		 */
+		template<typename CharT, typename IndexT>
+		static void sais_buckets(const CharT * s, IndexT n, IndexT upper, vector<IndexT> & bkt, bool end) {
+			std::fill(bkt.begin(), bkt.end(), 0);
+			for (IndexT i = 0; i < n; i++) bkt[s[i]]++;
+			IndexT sum = 0;
+			for (size_t c = 0; c <= (size_t)upper; c++) {
+				sum += bkt[c];
+				bkt[c] = end ? sum : sum - bkt[c];
+			}
+		}
+
+		/**
+		 * the L suffixs from the left, then the S suffixs from the right,
+		 * out of the LMS suffixs in sa
+		 */
+		template<typename CharT, typename IndexT>
+		static void sais_induce(const CharT * s, IndexT n, IndexT upper, const vector<bool> & ls,
+				vector<IndexT> & bkt, IndexT * sa) {
+			const IndexT NONE = (IndexT)-1;
+			sais_buckets(s, n, upper, bkt, false);
+			sa[bkt[s[n - 1]]++] = n - 1;		// after the virtual sentinel
+			for (IndexT i = 0; i < n; i++) {
+				IndexT v = sa[i];
+				if (v != NONE && v >= 1 && !ls[v - 1]) sa[bkt[s[v - 1]]++] = v - 1;
+			}
+			sais_buckets(s, n, upper, bkt, true);
+			for (IndexT i = n; i-- > 0;) {
+				IndexT v = sa[i];
+				if (v != NONE && v >= 1 && ls[v - 1]) sa[--bkt[s[v - 1]]] = v - 1;
+			}
+		}
+
+		/**
+		 * SA-IS of s[0..n) over the alphabet [0, upper], into sa[0..n).
+		 * the sentinel is virtual: a suffix that is a prefix of another
+		 * sorts first.
+		 *
+		 * besides sa: n bits of types & a bucket per char. the names of
+		 * the LMS substrings, the reduced string & its suffix array live
+		 * in sa, there are at most n / 2 LMS suffixs.
+		 */
+		template<typename CharT, typename IndexT>
+		static void sais(const CharT * s, IndexT n, IndexT upper, IndexT * sa) {
+			const IndexT NONE = (IndexT)-1;
+			if (n == 0) return;
+			if (n == 1) {
+				sa[0] = 0;
+				return;
+			}
+			if (n == 2) {
+				sa[0] = s[0] < s[1] ? 0 : 1;
+				sa[1] = 1 - sa[0];
+				return;
+			}
+
+			// the type of every suffix: S (true) is smaller than the next one
+			vector<bool> ls(n, false);
+			for (IndexT i = n - 1; i-- > 0;) {
+				ls[i] = s[i] == s[i + 1] ? ls[i + 1] : s[i] < s[i + 1];
+			}
+			vector<IndexT> bkt((size_t)upper + 1);
+
+			// the LMS suffixs at the ends of their buckets sort the LMS
+			// substrings
+			std::fill(sa, sa + n, NONE);
+			sais_buckets(s, n, upper, bkt, true);
+			for (IndexT i = 1; i < n; i++) {
+				if (sais_lms(ls, i)) sa[--bkt[s[i]]] = i;
+			}
+			sais_induce(s, n, upper, ls, bkt, sa);
+
+			// the sorted LMS substrings to the front
+			IndexT m = 0;
+			for (IndexT i = 0; i < n; i++) {
+				if (sais_lms(ls, sa[i])) sa[m++] = sa[i];
+			}
+			if (m == 0) return;
+
+			// name them in sorted order, equal ones alike. two LMS positions
+			// are 2 apart at least: the name of p goes to sa[m + p / 2].
+			std::fill(sa + m, sa + n, NONE);
+			IndexT name = 0, prev = NONE;
+			for (IndexT i = 0; i < m; i++) {
+				IndexT pos = sa[i];
+				bool same = prev != NONE;
+				for (IndexT d = 0; same; d++) {
+					if (pos + d == n || prev + d == n || s[pos + d] != s[prev + d] || ls[pos + d] != ls[prev + d]) {
+						same = false;
+					} else if (d > 0 && sais_lms(ls, pos + d)) {
+						break;
+					}
 				}
+				if (!same) {
+					name++;
+					prev = pos;
+				}
+				sa[m + pos / 2] = name - 1;
+			}
+			// the reduced string, in text order, to the back
+			for (IndexT i = n, j = n; i-- > m;) {
+				if (sa[i] != NONE) sa[--j] = sa[i];
 			}
 
-			bool equal(int a, int b) {
-				return !less_than(a,b) && !less_than(b,a);
+			// the order of the LMS suffixs in sa[0..m), recursively if some
+			// names repeat
+			IndexT * rec_s = sa + n - m;
+			if (name < m) {
+				sais(rec_s, m, name - 1, sa);
+			} else {
+				for (IndexT i = 0; i < m; i++) sa[rec_s[i]] = i;
 			}
 
+			// from ranks to LMS positions, then at the ends of their buckets
+			for (IndexT i = 1, j = 0; i < n; i++) {
+				if (sais_lms(ls, i)) rec_s[j++] = i;
+			}
+			for (IndexT i = 0; i < m; i++) sa[i] = rec_s[sa[i]];
+			std::fill(sa + m, sa + n, NONE);
+			sais_buckets(s, n, upper, bkt, true);
+			for (IndexT i = m; i-- > 0;) {
+				IndexT j = sa[i];
+				sa[i] = NONE;
+				sa[--bkt[s[j]]] = j;
+			}
+			sais_induce(s, n, upper, ls, bkt, sa);
+		}
+	}
+
+	/**
+	 * the suffix array of the bytes s[0..n) into sa[0..n)
+	 */
+	template<typename IndexT>
+	static void sais(const unsigned char * s, IndexT n, IndexT * sa) {
+		detail::sais(s, n, (IndexT)255, sa);
+	}
+
+	/**
+	 * the LCP array of s[0..n) & its suffix array: lcp[i] is the longest
+	 * common prefix of the suffixs sa[i-1] & sa[i], lcp[0] = 0. takes n
+	 * more indices, for the ranks.
+	 */
+	template<typename IndexT>
+	static void kasai(const unsigned char * s, IndexT n, const IndexT * sa, IndexT * lcp) {
+		if (n == 0) return;
+		vector<IndexT> rank(n);
+		for (IndexT i = 0; i < n; i++) rank[sa[i]] = i;
+		lcp[0] = 0;
+		IndexT h = 0;
+		for (IndexT i = 0; i < n; i++) {
+			if (rank[i] == 0) {
+				h = 0;
+				continue;
+			}
+			IndexT j = sa[rank[i] - 1];
+			while (i + h < n && j + h < n && s[i + h] == s[j + h]) h++;
+			lcp[rank[i]] = h;
+			if (h > 0) h--;
+		}
+	}
+
+	class SuffixArray {
+		private:
+			static const uint32_t BLOCK = 32;		// LCP entries under a minimum of the table
+
+			const unsigned char * str;
+			uint32_t N;
+			vector<uint32_t> suffix;
+			vector<uint32_t> rank;
+			vector<uint32_t> lcp;
+			// table[k][b]: the minimum of the LCP blocks b .. b + 2^k - 1
+			vector<vector<uint32_t> > table;
+
+			void build();
+			uint32_t lcp_min(uint32_t l, uint32_t r) const;
+
 		public:
-			explicit SuffixArray(const string& s) : N(s.size()), L(0), K(0), str(s) { suffix_sort();}
+			/**
+			 * the string, or the bytes, must outlive the suffix array
+			 */
+			explicit SuffixArray(const string& s) : str((const unsigned char *)s.data()), N(0) {
+				if (s.size() >= UINT32_MAX) throw length_error("string too long");
+				N = (uint32_t)s.size();
+				build();
+			}
+			SuffixArray(const unsigned char * s, size_t n) : str(s), N(0) {
+				if (n >= UINT32_MAX) throw length_error("string too long");
+				N = (uint32_t)n;
+				build();
+			}
+
+			uint32_t size() const { return N; }
 			// return the sorted suffix
-			int operator [] (int i) { return suffix[i];}
+			uint32_t operator [] (uint32_t i) const { return suffix[i];}
+			// the position of suffix x in the sorted order
+			uint32_t rank_of(uint32_t x) const { return rank[x]; }
+			// the longest common prefix of the suffixs [i-1] & [i], 0 for i == 0
+			uint32_t lcp_at(uint32_t i) const { return lcp[i]; }
 			// Given two suffixs of string, return the longest common prefix length
-			int lcp_length(int x, int y);
+			uint32_t lcp_length(uint32_t x, uint32_t y) const;
 	};
 
-	void SuffixArray::suffix_sort() {
-		// init suffix
+	void SuffixArray::build() {
 		suffix.resize(N);
-		for(int i=0;i<N;i++) suffix[i]=i;
-		// init bucket
-		bucket.resize(ceil(log2(N))+1);
-		for(size_t k=0;k<bucket.size();k++) bucket[k].resize(N+N);
-
-		for(L=1,K=0;(L>>1)<N;L<<=1,K++) {
-			sort(suffix.begin(), suffix.end(), std::bind(&SuffixArray::less_than, *this, placeholders::_1, placeholders::_2));
-			update_bucket();
+		lcp.resize(N);
+		rank.resize(N);
+		if (N == 0) return;
+		sais(str, N, &suffix[0]);
+		kasai(str, N, &suffix[0], &lcp[0]);
+		for (uint32_t i = 0; i < N; i++) rank[suffix[i]] = i;
+
+		uint32_t nb = (N + BLOCK - 1) / BLOCK;
+		table.resize(1);
+		table[0].assign(nb, UINT32_MAX);
+		for (uint32_t i = 0; i < N; i++) table[0][i / BLOCK] = std::min(table[0][i / BLOCK], lcp[i]);
+		for (uint32_t k = 1; (1u << k) <= nb; k++) {
+			table.push_back(vector<uint32_t>(nb - (1u << k) + 1));
+			for (uint32_t b = 0; b + (1u << k) <= nb; b++) {
+				table[k][b] = std::min(table[k - 1][b], table[k - 1][b + (1u << (k - 1))]);
+			}
 		}
 	}
 
-
-	void SuffixArray::update_bucket() {
-		int seq=0;
-		bucket[K][suffix[0]]=0;
-		for(int i=1;i<N;i++) {
-			if(!equal(suffix[i],suffix[i-1])) seq++;
-			bucket[K][suffix[i]]=seq;
+	/**
+	 * the minimum of lcp[l..r], l <= r
+	 */
+	uint32_t SuffixArray::lcp_min(uint32_t l, uint32_t r) const {
+		uint32_t bl = l / BLOCK, br = r / BLOCK, m = UINT32_MAX;
+		if (bl == br || bl + 1 == br) {
+			for (uint32_t i = l; i <= r; i++) m = std::min(m, lcp[i]);
+			return m;
 		}
-		fill(bucket[K].begin()+N, bucket[K].end(), -1);
+		// the partial blocks at both ends, the whole ones in between
+		for (uint32_t i = l; i < (bl + 1) * BLOCK; i++) m = std::min(m, lcp[i]);
+		for (uint32_t i = br * BLOCK; i <= r; i++) m = std::min(m, lcp[i]);
+		uint32_t a = bl + 1, b = br - 1, k = 0;
+		while ((2u << k) <= b - a + 1) k++;
+		return std::min(m, std::min(table[k][a], table[k][b - (1u << k) + 1]));
 	}
 
-	int SuffixArray::lcp_length(int x, int y) {
+	uint32_t SuffixArray::lcp_length(uint32_t x, uint32_t y) const {
 		if(x==y) return N-x;
-		int ret=0;
-		for(int k=K-1;k>=0 && x<N && y<N;k--) {
-			if(bucket[k][x]==bucket[k][y]) {
-				x += (1<<k);
-				y += (1<<k);
-				ret += (1<<k);
-			}
-		}
-		return ret;
+		uint32_t a = rank[x], b = rank[y];
+		if (a > b) std::swap(a, b);
+		return lcp_min(a + 1, b);
 	}
 }
 
@@ -1,316 +1,451 @@
-#include <string>
-//#include <tr1/unordered_map>
-#include <limits>
-#include <map>
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * SUFFIX TREE
+ *
+ * Features:
+ * 1. Ukkonen's online construction in O(n) expected, over any alphabet of
+ *    unsigned integers up to 32 bits (bytes, 16-bit code units, token ids).
+ *    the end of the text is a virtual terminator, smaller than all.
+ * 2. flat arrays, no object per node: an internal node is its edge
+ *    [start, end) of the text & its children, a leaf is only an entry in
+ *    the children of its parent. while building, the children are an open
+ *    addressing table of (parent, child), 8 bytes, keyed by the parent &
+ *    the first symbol of the edge. afterwards, sorted sibling arrays:
+ *    about 16 bytes a character in all, 25 to 40 at the peak.
+ * 3. search / count / locate of a pattern in O(m log(sigma)) + occ, and
+ *    count over a batch of patterns, sorted so that a common prefix with
+ *    the previous pattern is not walked again.
+ *
+ * The text is not copied, it must outlive the tree. Up to 2^31 - 2
+ * symbols.
+ *
+ * http://en.wikipedia.org/wiki/Suffix_tree
+ * http://en.wikipedia.org/wiki/Ukkonen%27s_algorithm
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_SUFFIX_TREE_H__
+#define ALGO_SUFFIX_TREE_H__
+
+#include <stdint.h>
 #include <vector>
-#include <iostream>
+#include <string>
+#include <algorithm>
 #include <stdexcept>
+#include <iostream>
 
-using std::vector;
-using std::string;
-using std::map;
-using std::make_pair;
-using std::cout;
-using std::endl;
-using std::out_of_range;
-using std::ostream;
-//typedef tr1::unordered_map map;
-
-// TODO: upgrade it to process trace. Rule: char-->elem  string-->elem_list
-class SuffixTree
-{
-public:
-	// active point is initialized as (root, None, 0), remainder initialized as 1
-	SuffixTree(string str):test_str(str), root(test_str), active_point(&root, 0, 0), remainder(0), pos(0), active_e(0), ls() {}
-	int construct(void);
-
-	// return -1 if no such sub exist, return the beginning position of this substring in thr original string if it exist
-	int search(string sub);
-
-	// return the length of the longest prefix of sub which can be matched in suffix tree
-	template <class Iterator>
-	Iterator inc_search(Iterator sub)
-	{
-		Iterator result = sub;
-		Node* node = &root;
-		Edge* edge = NULL;
-		int pos = 0;	// the iter's pos at edge
-		int edge_len = -1;
-		bool flag = true;
-
-
-		while (flag) {
-			if (edge == NULL) {
-				edge = node->find_edge(*result);	
-				if (edge == NULL) {
-					flag = false;
-				}
-				else {
-					result++;
-					pos = 1; // the second element of the edge
-					edge_len = edge->length();
-				}
+namespace alg {
+	template<typename T>
+	class BasicSuffixTree {
+		private:
+			enum {
+				ROOT = 0,
+				LEAF = 0x80000000u,		// a child that is a leaf: LEAF | start of its edge
+				NONE = 0xffffffffu
+			};
+			static const uint64_t EMPTY = ~0ULL;
+
+			/**
+			 * matched so far: at node, or off symbols into the edge of child
+			 */
+			struct Locus {
+				uint32_t node;
+				uint32_t child;
+				uint32_t off;
+			};
+
+			const T * m_s;
+			uint32_t m_n;
+			// the internal nodes: edge [m_start, m_end), children
+			// m_child[m_first[u] .. m_first[u + 1]) by first symbol
+			std::vector<uint32_t> m_start, m_end;
+			std::vector<uint32_t> m_first, m_child;
+			std::vector<uint32_t> m_leaves;		// leaves under a node
+
+			// while building: suffix links, the (parent, child) table
+			std::vector<uint32_t> m_link;
+			std::vector<uint64_t> m_table;
+			size_t m_used;
+			uint32_t m_shift;					// 64 - log2(table size)
+
+		public:
+			/**
+			 * the suffix tree of s[0..n)
+			 */
+			BasicSuffixTree(const T * s, size_t n) : m_s(s), m_n(0), m_used(0), m_shift(0) {
+				if (n >= LEAF - 1) throw std::length_error("text too long");
+				m_n = (uint32_t)n;
+				build();
+			}
+
+			/**
+			 * the suffix tree of a byte string, for T of one byte
+			 */
+			explicit BasicSuffixTree(const std::string & s) : m_s((const T *)s.data()), m_n(0), m_used(0), m_shift(0) {
+				if (sizeof(T) != 1) throw std::invalid_argument("not a byte alphabet");
+				if (s.size() >= LEAF - 1) throw std::length_error("text too long");
+				m_n = (uint32_t)s.size();
+				build();
+			}
+
+			uint32_t size() const { return m_n; }
+			uint32_t internal_count() const { return (uint32_t)m_start.size(); }
+
+			/**
+			 * the memory of the tree, in bytes
+			 */
+			size_t bytes() const {
+				return (m_start.size() + m_end.size() + m_first.size() + m_child.size() + m_leaves.size()) * sizeof(uint32_t);
 			}
-			else {
-				if (pos >= edge_len) {
-					node = edge->endpoint;
-					edge = NULL;
-					edge_len = 0;
+
+			/**
+			 * a position of p[0..m) in the text, -1 if none (or m is 0)
+			 */
+			int64_t search(const T * p, size_t m) const {
+				Locus at;
+				if (!match(p, m, at)) return -1;
+				uint64_t depth = m - at.off;
+				uint32_t c = at.child;
+				// down the first children to a leaf
+				while (!(c & LEAF)) {
+					depth += m_end[c] - m_start[c];
+					at.node = c;
+					c = m_child[m_first[c]];
 				}
-				else {
-					if (*result == (*edge)[pos]) {
-						result++;
-						pos++;
+				return (int64_t)((c & ~(uint32_t)LEAF) - depth);
+			}
+			int64_t search(const std::string & p) const { return search((const T *)p.data(), bytes_of(p)); }
+
+			/**
+			 * the number of occurrences of p[0..m)
+			 */
+			uint32_t count(const T * p, size_t m) const {
+				Locus at;
+				return match(p, m, at) ? leaves(at.child) : 0;
+			}
+			uint32_t count(const std::string & p) const { return count((const T *)p.data(), bytes_of(p)); }
+
+			/**
+			 * the positions of p[0..m), ascending
+			 */
+			void locate(const T * p, size_t m, std::vector<uint32_t> & pos) const {
+				pos.clear();
+				Locus at;
+				if (!match(p, m, at)) return;
+				pos.reserve(leaves(at.child));
+				// (node, its string depth) to visit
+				std::vector<std::pair<uint32_t, uint32_t> > stack;
+				uint32_t depth = (uint32_t)(m - at.off);
+				if (at.child & LEAF) pos.push_back((at.child & ~(uint32_t)LEAF) - depth);
+				else stack.push_back(std::make_pair(at.child, depth + m_end[at.child] - m_start[at.child]));
+				while (!stack.empty()) {
+					uint32_t u = stack.back().first, d = stack.back().second;
+					stack.pop_back();
+					for (uint32_t k = m_first[u]; k < m_first[u + 1]; k++) {
+						uint32_t c = m_child[k];
+						if (c & LEAF) {
+							// a leaf edge ends at the terminator: no suffix starts at n
+							if ((c & ~(uint32_t)LEAF) - d < m_n) pos.push_back((c & ~(uint32_t)LEAF) - d);
+						} else {
+							stack.push_back(std::make_pair(c, d + m_end[c] - m_start[c]));
+						}
 					}
-					else
-						flag = false;
 				}
+				std::sort(pos.begin(), pos.end());
 			}
-		}
-		
-		return result;
-	}
-
-	struct Node;
-	struct Edge{
-		// the begin and end pos of this edge, note that INT_MAX stands for #(the changing end pos of this entire string)
-		unsigned int begin, end;
-		// Is there a better way to find test_str?
-		string& test_node_str;
-
-		Node * endpoint;
-
-		Edge(unsigned int b, unsigned int e, string& str):
-			test_node_str(str) 
-		{
-			begin = b;
-			end = e;
-			endpoint = NULL;
-			std::cout << "Edge initialized" << std::endl;
-		}
-
-		void change_edge(unsigned int b, unsigned int e)
-		{
-			begin = b;
-			end = e;
-		}
-
-		int length(void) 
-		{
-
-			if (end > test_node_str.size())
-				return test_node_str.size() - begin;
-			else
-				return end - begin + 1; 
-		}
-		
-		// needed by map
-		friend bool operator<(const Edge& me, const Edge& other)
-		{
-			return me.begin < other.begin;
-		}
-
-		char operator[](unsigned int i)
-		{
-			i += begin;
-			if (i > end)
-				throw out_of_range("Edge [] out of range.");
-
-			return test_node_str[i];
-		}
-
-		friend ostream& operator<<(ostream& os, Edge& edge)
-		{
-			unsigned int end = edge.test_node_str.size()-1;
-			if (end >= edge.end)
-				end = edge.end;
-
-			char c;
-			for (unsigned int i=edge.begin; i<=end; i++) {
-				c = edge.test_node_str[i];
-				os << c;
+			void locate(const std::string & p, std::vector<uint32_t> & pos) const {
+				locate((const T *)p.data(), bytes_of(p), pos);
 			}
-			if (end != edge.end)
-				os << '#';
 
-			return os;
-		}
+			/**
+			 * the counts of a batch of patterns, any sequences of symbols
+			 * (std::string, std::vector<T> ...). the patterns are taken in
+			 * sorted order, each resumes from its common prefix with the
+			 * previous one.
+			 */
+			template<typename Seq>
+			void count(const std::vector<Seq> & patterns, std::vector<uint32_t> & counts) const {
+				counts.assign(patterns.size(), 0);
+				std::vector<uint32_t> order(patterns.size());
+				for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+				std::sort(order.begin(), order.end(), SeqLess<Seq>(patterns));
+
+				// path[k]: the locus after k symbols of the previous pattern
+				std::vector<Locus> path(1);
+				path[0].node = ROOT;
+				path[0].child = NONE;
+				path[0].off = 0;
+				const Seq * prev = NULL;
+				for (size_t i = 0; i < order.size(); i++) {
+					const Seq & p = patterns[order[i]];
+					size_t k = 0, matched = path.size() - 1;
+					if (prev) {
+						while (k < matched && k < p.size() && (T)(*prev)[k] == (T)p[k]) k++;
+					}
+					path.resize(k + 1);
+					Locus at = path[k];
+					for (; k < p.size(); k++) {
+						if (!step(at, (T)p[k])) break;
+						path.push_back(at);
+					}
+					if (k == p.size() && k > 0) counts[order[i]] = leaves(at.child);
+					prev = &p;
+				}
+			}
 
-		bool is_none(void) { return begin == 0 && end == 0; }
-	};
+			/**
+			 * the edges, one per line, indented by depth; for small trees
+			 */
+			void print(std::ostream & os) const { print(os, ROOT, 0); }
+
+		private:
+			template<typename Seq>
+			struct SeqLess {
+				const std::vector<Seq> & v;
+				explicit SeqLess(const std::vector<Seq> & v) : v(v) {}
+				bool operator()(uint32_t a, uint32_t b) const {
+					const Seq & x = v[a], & y = v[b];
+					for (size_t k = 0; k < x.size() && k < y.size(); k++) {
+						if ((T)x[k] != (T)y[k]) return (T)x[k] < (T)y[k];
+					}
+					return x.size() < y.size();
+				}
+			};
 
-	struct Node{
-		string& test_node_str;
-		map<int, int> testmap;
-		map<Edge*, bool> edges;
-		// find the edge quicky by storing the leading char of this edge
-		map<char, Edge*> findedges;
-		Node* suffix_link;
-
-		friend class LinkState;
-
-		Node(string& str) : 
-			test_node_str(str), suffix_link(NULL) { edges.clear(); findedges.clear(); }
-
-		void add_edge(Edge* edge) { 
-			if (edge->endpoint == NULL)
-				edge->endpoint = new Node(test_node_str);
-			make_pair(edge, true);
-			edges.insert(make_pair(edge, true)); 
-			findedges.insert(make_pair(test_node_str[edge->begin], edge));
-			cout << "edge added. Now we have " << edges.size() << "edges." << endl;
-		}
-
-		void del_edge(Edge* edge) {
-			map<Edge*, bool>::iterator iter = edges.find(edge);
-
-			if (iter == edges.end())
-				throw out_of_range("edge don't exit");
-			else {
-				// note we should erase the findedges too
-				edges.erase(edge);
-				cout << "delete" << (*edge)[0] << endl;
-				findedges.erase((*edge)[0]);
-				cout << "edge deleted. Now we have " << edges.size() << "edges." << endl;
-			}
+			struct FirstLess {
+				const BasicSuffixTree * t;
+				explicit FirstLess(const BasicSuffixTree * t) : t(t) {}
+				bool operator()(uint32_t a, uint32_t b) const { return t->sym(t->start(a)) < t->sym(t->start(b)); }
+			};
 
-		}
+			static size_t bytes_of(const std::string & p) {
+				if (sizeof(T) != 1) throw std::invalid_argument("not a byte alphabet");
+				return p.size();
+			}
 
-		// find edge by the first char
-		Edge* find_edge(char c)
-		{
-			cout << "finding edge char " << c;
-			map<char, Edge*>::iterator iter = findedges.find(c);
-			cout << " founded? ";
+			/**
+			 * the symbol at i: 0 for the terminator, the others shifted by 1
+			 */
+			inline uint64_t sym(uint32_t i) const { return i < m_n ? (uint64_t)m_s[i] + 1 : 0; }
+			inline uint32_t start(uint32_t c) const { return c & LEAF ? c & ~(uint32_t)LEAF : m_start[c]; }
+			// a leaf edge runs to the terminator included
+			inline uint32_t end(uint32_t c) const { return c & LEAF ? m_n + 1 : m_end[c]; }
+			inline uint32_t leaves(uint32_t c) const { return c & LEAF ? 1 : m_leaves[c]; }
+
+			// the table while building
+			inline size_t slot(uint32_t node, uint64_t c) const {
+				// the high bits of a multiplicative hash
+				uint64_t h = (node ^ c * 0xbf58476d1ce4e5b9ULL) * 0x9e3779b97f4a7c15ULL;
+				size_t mask = m_table.size() - 1, i = (size_t)(h >> m_shift);
+				for (;;) {
+					uint64_t e = m_table[i];
+					if (e == EMPTY || ((uint32_t)(e >> 32) == node && sym(start((uint32_t)e)) == c)) return i;
+					i = (i + 1) & mask;
+				}
+			}
 
-			if (iter != findedges.end()) {
-				cout << "yes." << endl;
-				return iter->second;
+			inline uint32_t find(uint32_t node, uint64_t c) const {
+				uint64_t e = m_table[slot(node, c)];
+				return e == EMPTY ? (uint32_t)NONE : (uint32_t)e;
 			}
-			else {
-				cout << "no." << endl;
-				return NULL;
+
+			void insert(uint32_t node, uint32_t child) {
+				m_table[slot(node, sym(start(child)))] = (uint64_t)node << 32 | child;
+				if (++m_used * 4 > m_table.size() * 3) {
+					std::vector<uint64_t> old(m_table.size() * 2, (uint64_t)EMPTY);
+					old.swap(m_table);
+					m_shift--;
+					for (size_t i = 0; i < old.size(); i++) {
+						if (old[i] != EMPTY) {
+							m_table[slot((uint32_t)(old[i] >> 32), sym(start((uint32_t)old[i])))] = old[i];
+						}
+					}
+				}
 			}
-		}
 
-		bool isleaf() { return edges.empty(); }
+			uint32_t new_node(uint32_t s, uint32_t e) {
+				m_start.push_back(s);
+				m_end.push_back(e);
+				m_link.push_back(ROOT);
+				return (uint32_t)m_start.size() - 1;
+			}
 
-		bool operator==(Node& other)
-		{
-			return (this) == (&other);
-		}
+			void build() {
+				// about 1.65 entries a character: room for them at 3/4 load
+				size_t cap = 16;
+				m_shift = 60;
+				while (cap * 9 < (size_t)m_n * 20) {
+					cap *= 2;
+					m_shift--;
+				}
+				m_table.assign(cap, (uint64_t)EMPTY);
+				m_start.reserve(m_n / 2 + 1);
+				m_end.reserve(m_n / 2 + 1);
+				m_link.reserve(m_n / 2 + 1);
+				new_node(0, 0);
+
+				// the active point: node, edge starting at text[edge], length
+				uint32_t node = ROOT, edge = 0, length = 0, remainder = 0;
+				for (uint32_t pos = 0; pos <= m_n; pos++) {
+					uint32_t need_link = NONE;
+					uint64_t c = sym(pos);
+					remainder++;
+					while (remainder > 0) {
+						if (length == 0) edge = pos;
+						uint32_t next = find(node, sym(edge));
+						if (next == NONE) {
+							insert(node, LEAF | pos);
+							if (need_link != NONE) m_link[need_link] = node;
+							need_link = node;
+						} else {
+							// walk down a whole edge
+							uint32_t len = std::min(end(next), pos + 1) - start(next);
+							if (length >= len) {
+								edge += len;
+								length -= len;
+								node = next;
+								continue;
+							}
+							if (sym(start(next) + length) == c) {
+								length++;
+								if (need_link != NONE) m_link[need_link] = node;
+								break;
+							}
+							// split the edge, then a leaf for pos
+							uint32_t split = new_node(start(next), start(next) + length);
+							m_table[slot(node, sym(edge))] = (uint64_t)node << 32 | split;
+							if (next & LEAF) next += length;
+							else m_start[next] += length;
+							insert(split, next);
+							insert(split, LEAF | pos);
+							if (need_link != NONE) m_link[need_link] = split;
+							need_link = split;
+						}
+						remainder--;
+						if (node == ROOT && length > 0) {
+							length--;
+							edge = pos - remainder + 1;
+						} else {
+							node = m_link[node];
+						}
+					}
+				}
+				freeze();
+			}
 
-		friend ostream& operator<<(ostream& os, Node& node)
-		{
-			map<Edge*, bool>::iterator iter;
-			map<char, Edge*>::iterator iter_f;
+			/**
+			 * the table into sorted sibling arrays, the leaf counts
+			 */
+			void freeze() {
+				uint32_t ni = (uint32_t)m_start.size();
+				m_first.assign(ni + 1, 0);
+				for (size_t i = 0; i < m_table.size(); i++) {
+					if (m_table[i] != EMPTY) m_first[(m_table[i] >> 32) + 1]++;
+				}
+				for (uint32_t u = 0; u < ni; u++) m_first[u + 1] += m_first[u];
+				m_child.resize(m_first[ni]);
+				std::vector<uint32_t> fill(m_first.begin(), m_first.end() - 1);
+				for (size_t i = 0; i < m_table.size(); i++) {
+					if (m_table[i] != EMPTY) m_child[fill[m_table[i] >> 32]++] = (uint32_t)m_table[i];
+				}
+				std::vector<uint64_t>().swap(m_table);
+				std::vector<uint32_t>().swap(m_link);
+				std::vector<uint32_t>().swap(fill);
+				for (uint32_t u = 0; u < ni; u++) {
+					std::sort(m_child.begin() + m_first[u], m_child.begin() + m_first[u + 1], FirstLess(this));
+				}
 
-			for (iter=node.edges.begin(); iter!=node.edges.end(); ++iter)
-				os << iter->first << '\t';
-			os << endl;
-			
-			for (iter_f=node.findedges.begin(); iter_f!=node.findedges.end(); ++iter_f)
-				os << iter_f->first << "-->" << iter_f->second << endl;
+				// the leaves under a node, children before parents
+				m_leaves.assign(ni, 0);
+				std::vector<uint32_t> order;
+				order.reserve(ni);
+				order.push_back(ROOT);
+				for (size_t i = 0; i < order.size(); i++) {
+					uint32_t u = order[i];
+					for (uint32_t k = m_first[u]; k < m_first[u + 1]; k++) {
+						if (!(m_child[k] & LEAF)) order.push_back(m_child[k]);
+					}
+				}
+				for (size_t i = order.size(); i-- > 0;) {
+					uint32_t u = order[i], n = 0;
+					for (uint32_t k = m_first[u]; k < m_first[u + 1]; k++) {
+						// the leaf of the empty suffix, $ under the root, is none
+						uint32_t c = m_child[k];
+						n += c & LEAF ? (u != ROOT || start(c) != m_n) : m_leaves[c];
+					}
+					m_leaves[u] = n;
+				}
+			}
 
-			return os;
-		}
-	};
-	int print_tree(void);
-private:
-	string test_str;
-	class ActivePoint{
-	public:
-		Node* active_node;
-		char active_edge;
-		int active_length;
-
-		ActivePoint(Node* node, char edge, int length): 
-			active_node(node), active_edge(edge), active_length(length) { std::cout << "ActivePoint initialized" << std::endl; }
-	};
+			/**
+			 * the child of u by its first symbol, a binary search
+			 */
+			inline uint32_t child(uint32_t u, uint64_t c) const {
+				uint32_t lo = m_first[u], hi = m_first[u + 1];
+				while (lo < hi) {
+					uint32_t mid = lo + (hi - lo) / 2;
+					uint64_t x = sym(start(m_child[mid]));
+					if (x == c) return m_child[mid];
+					if (x < c) lo = mid + 1;
+					else hi = mid;
+				}
+				return NONE;
+			}
 
-	Node root;
-	ActivePoint active_point;
-
-	Node* get_active_node(void) { return active_point.active_node; }
-	void set_active_node(Node* node) { active_point.active_node = node; cout << "Active node set as " << node << endl; }
-	char get_active_edge(void) 
-	{ 
-		return test_str[active_e]; 
-	}
-
-	int get_active_length(void) { return active_point.active_length; }
-	void set_active_length(int len) { active_point.active_length = len; }
-	void inc_active_len() { active_point.active_length++; }
-	void dec_active_len() { active_point.active_length--; }
-	
-	// how many suffixes is to be inserted?
-	int remainder;
-	// how many characters inserted?
-	unsigned int pos;
-	unsigned int active_e;	// the beginning position of suffixes need to be inserted
-	char get_ele(int i) { return test_str[i]; }
-	// insert a char from pos to suffix tree
-	int insert();
-	int insert_rule1();
-	int insert_rule3();
-	int print_node(Node* node, int level);
-
-
-	Node* separate_edge(Node * node, Edge* edge);
-
-	// check if we can change active node
-	bool check_active_node(void)
-	{
-		Node* node = get_active_node();
-		char a_char = get_active_edge();
-		Edge* edge = node->find_edge(a_char);
-
-		if (edge == NULL)
-			return false;
-
-		unsigned int edge_size = edge->end - edge->begin + 1;
-		unsigned int length = get_active_length();
-		
-		// update
-		if (length >= edge_size) {
-			set_active_node(edge->endpoint);
-			set_active_length(length-edge_size);
-			active_e += edge_size;
-			
-			return true;
-		}
-		return false;
-	}
-
-	// this class indicate when shall we insert a suffix link
-	// ls should be a singleton
-	class LinkState
-	{
-		bool first;
-		
-		Node* prev, *curr;
-
-	public:
-		LinkState() : first(true), prev(NULL), curr(NULL) {}
-
-		void ins_link(Node* node)
-		{
-			prev = curr;
-			curr = node;
-			
-			if (first == false) {
-				prev->suffix_link = curr;
-				cout << "Suffix link added from prev " << prev << " to curr " << curr << endl;
+			/**
+			 * one more symbol from the locus, false if the text has none
+			 */
+			inline bool step(Locus & at, T x) const {
+				uint64_t c = (uint64_t)x + 1;
+				if (at.child != NONE && at.off == end(at.child) - start(at.child)) {
+					at.node = at.child;
+					at.child = NONE;
+				}
+				if (at.child == NONE) {
+					uint32_t next = child(at.node, c);
+					if (next == NONE) return false;
+					at.child = next;
+					at.off = 1;
+					return true;
+				}
+				if (sym(start(at.child) + at.off) != c) return false;
+				at.off++;
+				return true;
 			}
 
-			first = false;
-		}
+			bool match(const T * p, size_t m, Locus & at) const {
+				if (m == 0) return false;
+				at.node = ROOT;
+				at.child = NONE;
+				at.off = 0;
+				for (size_t k = 0; k < m; k++) {
+					if (!step(at, p[k])) return false;
+				}
+				return true;
+			}
 
-		void clear(void)
-		{
-			first = true;
-			prev = curr = NULL;
-		}
+			void print(std::ostream & os, uint32_t u, int level) const {
+				for (uint32_t k = m_first[u]; k < m_first[u + 1]; k++) {
+					uint32_t c = m_child[k];
+					for (int i = 0; i < level; i++) os << '\t';
+					os << "--> ";
+					for (uint32_t i = start(c); i < end(c); i++) {
+						if (i == m_n) os << '$';
+						else if (sizeof(T) == 1) os << (char)m_s[i];
+						else os << (uint64_t)m_s[i] << ' ';
+					}
+					os << std::endl;
+					if (!(c & LEAF)) print(os, c, level + 1);
+				}
+			}
 	};
-	LinkState ls;
-};
+
+	typedef BasicSuffixTree<unsigned char> SuffixTree;
+}
+
+#endif //
@@ -0,0 +1,118 @@
+/*******************************************************************************
+ * DANIEL'S ALGORITHM IMPLEMENTAIONS
+ *
+ *  /\  |  _   _  ._ o _|_ |_  ._ _   _
+ * /--\ | (_| (_) |  |  |_ | | | | | _>
+ *         _|
+ *
+ * TRIANGLE COUNTING
+ *
+ * Features:
+ * 1. the edges are taken undirected, without self loops & duplicates, and
+ *    oriented from the lower to the higher degree (ties by index). every
+ *    triangle is then counted once, from its lowest vertex, and a vertex
+ *    keeps at most O(sqrt(E)) out-edges: O(E^1.5) in the worst case.
+ * 2. for every u, the out-neighbours of u are marked in a byte array, and
+ *    for each out-neighbour v the marks under the out-neighbours of v are
+ *    summed, a branch-free loop.
+ * 3. the vertices are handed out in chunks to nthreads threads (C++11),
+ *    each with its own marks.
+ *
+ * http://en.wikipedia.org/wiki/Triangle_graph
+ * Schank & Wagner, Finding, Counting and Listing all Triangles in Large
+ * Graphs, 2005
+ *
+ ******************************************************************************/
+
+#ifndef ALGO_TRIANGLE_COUNT_H__
+#define ALGO_TRIANGLE_COUNT_H__
+
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#if __cplusplus >= 201103L
+#include <atomic>
+#include <thread>
+#endif
+#include "csr_graph.h"
+
+namespace alg {
+	namespace detail {
+		/**
+		 * the triangles whose lowest vertex is in [begin, end), mark all 0
+		 */
+		static uint64_t count_triangles(const std::vector<uint32_t> & off, const std::vector<uint32_t> & adj,
+				uint32_t begin, uint32_t end, std::vector<uint8_t> & mark) {
+			uint64_t count = 0;
+			for (uint32_t u = begin; u < end; u++) {
+				for (uint32_t e = off[u]; e < off[u + 1]; e++) mark[adj[e]] = 1;
+				for (uint32_t e = off[u]; e < off[u + 1]; e++) {
+					uint32_t v = adj[e], c = 0;
+					for (uint32_t f = off[v]; f < off[v + 1]; f++) c += mark[adj[f]];
+					count += c;
+				}
+				for (uint32_t e = off[u]; e < off[u + 1]; e++) mark[adj[e]] = 0;
+			}
+			return count;
+		}
+	}
+
+	/**
+	 * the number of triangles of g, as an undirected graph
+	 */
+	static uint64_t triangle_count(const CSRGraph & g, int nthreads = 0) {
+		uint32_t n = g.vertex_count();
+		std::vector<uint32_t> deg(n, 0);
+		CSRGraph gt = g.transpose();
+		// the undirected degree, counting both directions of an edge
+		for (uint32_t u = 0; u < n; u++) deg[u] = g.degree(u) + gt.degree(u);
+
+		// the oriented edges, deduplicated
+		std::vector<uint32_t> off(n + 1, 0), adj;
+		adj.reserve(g.edge_count());
+		std::vector<uint32_t> tmp;
+		for (uint32_t u = 0; u < n; u++) {
+			tmp.clear();
+			for (int dir = 0; dir < 2; dir++) {
+				const CSRGraph & h = dir == 0 ? g : gt;
+				for (uint32_t e = h.begin(u); e < h.end(u); e++) {
+					uint32_t v = h.target(e);
+					if (deg[u] < deg[v] || (deg[u] == deg[v] && u < v)) tmp.push_back(v);
+				}
+			}
+			std::sort(tmp.begin(), tmp.end());
+			tmp.erase(std::unique(tmp.begin(), tmp.end()), tmp.end());
+			adj.insert(adj.end(), tmp.begin(), tmp.end());
+			off[u + 1] = (uint32_t)adj.size();
+		}
+
+		const uint32_t CHUNK = 1024;
+#if __cplusplus >= 201103L
+		if (nthreads <= 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+		nthreads = std::min<int>(nthreads, (n + CHUNK - 1) / CHUNK);
+		if (nthreads > 1) {
+			std::atomic<uint32_t> next(0);
+			std::atomic<uint64_t> total(0);
+			std::vector<std::thread> workers;
+			auto work = [&]() {
+				std::vector<uint8_t> mark(n, 0);
+				uint64_t count = 0;
+				for (uint32_t b; (b = next.fetch_add(CHUNK, std::memory_order_relaxed)) < n;) {
+					count += detail::count_triangles(off, adj, b, std::min(n, b + CHUNK), mark);
+				}
+				total.fetch_add(count, std::memory_order_relaxed);
+			};
+			for (int t = 1; t < nthreads; t++) workers.push_back(std::thread(work));
+			work();
+			for (size_t t = 0; t < workers.size(); t++) workers[t].join();
+			return total.load();
+		}
+#else
+		(void)nthreads;
+#endif
+		std::vector<uint8_t> mark(n, 0);
+		return detail::count_triangles(off, adj, 0, n, mark);
+	}
+}
+
+#endif //
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "aho_corasick.h"
+#include "kmp.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// the small example: overlapping patterns
+	const char * words[] = {"he", "she", "his", "hers"};
+	std::vector<std::string> small(words, words + 4);
+	AhoCorasick ac(small);
+	std::vector<AhoCorasick::Match> found;
+	ac.find_all(std::string("ushers"), found);
+	printf("in \"ushers\":");
+	for (size_t i = 0; i < found.size(); i++) printf(" %s@%d", words[found[i].pattern], (int)found[i].pos);
+	printf("\n");
+
+	// 8MB of log lines
+	const char * level[] = {"INFO", "WARN", "ERROR", "DEBUG"};
+	const char * what[] = {"connection accepted", "request served", "cache miss", "timeout", "retrying"};
+	std::string text;
+	while (text.size() < (8 << 20)) {
+		char line[128];
+		snprintf(line, sizeof(line), "2024-01-%02d %s [worker-%d] %s id=%d user=%x\n", 1 + rand() % 28,
+				level[rand() % 4], rand() % 64, what[rand() % 5], rand() % 100000, rand() % 0x100000);
+		text += line;
+	}
+
+	// 20000 signatures, some of them hit
+	std::vector<std::string> sig;
+	for (int i = 0; i < 20000; i++) {
+		char s[32];
+		if (i % 4 == 0) snprintf(s, sizeof(s), "id=%d user", rand() % 100000);
+		else snprintf(s, sizeof(s), "user=%x\n", rand() % 0x100000);
+		sig.push_back(s);
+	}
+
+	double t = now();
+	AhoCorasick big(sig);
+	printf("%d patterns: %u states, %.1fMB, built in %.3fs\n", (int)sig.size(), big.state_count(),
+			big.bytes() / 1048576.0, now() - t);
+
+	t = now();
+	big.find_all(text, found);
+	double t_all = now() - t;
+	printf("one pass over %.1fMB: %d matches in %.3fs, %.0fMB/s\n", text.size() / 1048576.0,
+			(int)found.size(), t_all, text.size() / 1048576.0 / t_all);
+
+	// the same in 4KB chunks
+	std::vector<AhoCorasick::Match> streamed;
+	AhoCorasick::Stream stream(big);
+	t = now();
+	for (size_t off = 0; off < text.size(); off += 4096) {
+		stream.feed(text.data() + off, std::min((size_t)4096, text.size() - off), streamed);
+	}
+	printf("in 4KB chunks: %d matches in %.3fs, %s\n", (int)streamed.size(), now() - t,
+			streamed.size() == found.size() ? "same" : "DIFFERENT");
+
+	// kmp_search, one pattern at a time, for the first hits only
+	const int K = 20;
+	t = now();
+	int hits = 0;
+	for (int i = 0; i < K; i++) {
+		if (kmp_search(text.c_str(), sig[i].c_str()) >= 0) hits++;
+	}
+	double t_kmp = now() - t;
+	printf("kmp_search: %d patterns in %.3fs (%d found), all %d would take ~%.0fs\n", K, t_kmp, hits,
+			(int)sig.size(), t_kmp / K * sig.size());
+	return 0;
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 #include "avl.h"
 
 using namespace std;
@@ -55,6 +56,14 @@ int main()
 
     printTreeStatus(avl);
 
+    cout << "Now bulk-building a tree from " << N << " sorted values... ";
+    sort(values, values + N);
+    AVL<int> bulk;
+    bulk.build_from_sorted(values, N);
+    cout << "Done" << endl;
+
+    printTreeStatus(bulk);
+
     // Outputting to cerr so the output can be redirected with ./avl_demo 2> <name>.gvz
     cout << "Do you want to output the GraphViz representation of the tree to the cerr stream (Y/n)? ";
     char usrInput;
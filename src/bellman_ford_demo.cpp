@@ -3,6 +3,8 @@
 #include <stdlib.h> 
 #include <time.h>
 #include <memory>
+#include <math.h>
+#include <vector>
 
 #include "directed_graph.h"
 #include "bellman_ford.h"
@@ -45,5 +47,81 @@ int main(void)
 	printf("\nwe %s have negative weighted cycle.\n", bf2.has_negative_cycle()?"DO":"DON'T");
 
 	delete g;
+
+	// a large sparse graph with negative weights, but no negative cycle:
+	// w(u,v) = c + p[u] - p[v], c >= 0
+	const uint32_t N = 1000000, M = 5000000;
+	std::vector<int32_t> p(N);
+	for (uint32_t i = 0; i < N; i++) p[i] = rand() % 1000;
+	std::vector<WeightedEdge> edges(M);
+	for (uint32_t i = 0; i < M; i++) {
+		edges[i].u = rand() % N;
+		edges[i].v = rand() % N;
+		edges[i].weight = rand() % 100 + p[edges[i].u] - p[edges[i].v];
+	}
+	CSRGraph big(N, &edges[0], M);
+
+	clock_t c = clock();
+	SPFA sp(big);
+	sp.run(0);
+	printf("\nV=%u E=%u: spfa %.3fs", N, M, (double)(clock() - c) / CLOCKS_PER_SEC);
+	c = clock();
+	std::vector<int64_t> dist;
+	std::vector<uint32_t> prev;
+	parallel_bellman_ford(big, 0, dist, prev);
+	printf(", parallel rounds %.3fs, %s\n", (double)(clock() - c) / CLOCKS_PER_SEC,
+			dist == sp.distances() ? "same distances" : "DIFFERENT");
+	if (dist != sp.distances()) return 1;
+
+	// arbitrage: w(u,v) = -log(rate(u,v)), a negative cycle is a sequence
+	// of trades ending with more than it started with
+	const uint32_t NC = 64;
+	std::vector<double> price(NC);
+	for (uint32_t i = 0; i < NC; i++) price[i] = exp((rand() % 1000) / 100.0);
+	std::vector<WeightedEdge> fx;
+	for (uint32_t u = 0; u < NC; u++) {
+		for (uint32_t v = 0; v < NC; v++) {
+			if (u == v) continue;
+			WeightedEdge e = {u, v, (int32_t)(-log(price[u] / price[v] * 0.999) * 1e6)};
+			fx.push_back(e);
+		}
+	}
+	CSRGraph market(NC, &fx[0], (uint32_t)fx.size());
+	SPFA detector(market);
+	detector.run_all();
+
+	const int TICKS = 10000;
+	int found = 0;
+	c = clock();
+	for (int t = 0; t < TICKS; t++) {
+		// a few quotes move every tick
+		uint32_t moved[4];
+		for (int k = 0; k < 4; k++) {
+			moved[k] = rand() % market.edge_count();
+			uint32_t e = moved[k];
+			double noise = (rand() % 3001 - 1500) / 1e6;
+			double rate = price[market.source(e)] / price[market.target(e)] * (0.999 + noise);
+			market.set_weight(e, (int32_t)(-log(rate) * 1e6));
+		}
+		if (!detector.update(moved, 4)) {
+			if (found++ == 0) {
+				printf("arbitrage:");
+				for (size_t i = 0; i < detector.cycle().size(); i++) printf(" %u ->", detector.cycle()[i]);
+				printf(" %u\n", detector.cycle()[0]);
+			}
+			// the quotes in the cycle get corrected
+			const std::vector<uint32_t> & cyc = detector.cycle();
+			std::vector<uint32_t> fixed;
+			for (size_t i = 0; i < cyc.size(); i++) {
+				uint32_t u = cyc[i], v = cyc[(i + 1) % cyc.size()];
+				uint32_t e = market.begin(u) + (v < u ? v : v - 1);
+				market.set_weight(e, (int32_t)(-log(price[u] / price[v] * 0.999) * 1e6));
+				fixed.push_back(e);
+			}
+			detector.update(&fixed[0], (uint32_t)fixed.size());
+		}
+	}
+	printf("%d ticks of a %u currency market: %d arbitrages, %.1fus per tick\n", TICKS, NC, found,
+			(double)(clock() - c) / CLOCKS_PER_SEC * 1e6 / TICKS);
 	return 0;	
 }
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <assert.h>
+#include <thread>
+#include <vector>
+#include "concurrent_skiplist.h"
+
+using namespace alg;
+
+static const int NUM_THREADS = 4;
+static const int PER_THREAD = 10000;
+
+int main()
+{
+	ConcurrentSkipList<int, int> ss;
+	std::vector<std::thread> workers;
+
+	// interleaved keys, every thread writes to the whole key range
+	for (int t = 0; t < NUM_THREADS; t++) {
+		workers.push_back(std::thread([&ss, t]() {
+			for (int i = 0; i < PER_THREAD; i++) {
+				int key = i * NUM_THREADS + t;
+				ss.insert(key, key * 10);
+			}
+		}));
+	}
+	for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+	workers.clear();
+	printf("inserted: %zu\n", ss.size());
+	assert(ss.size() == NUM_THREADS * PER_THREAD);
+
+	// concurrent deletion of the odd keys, racing on the same keys
+	for (int t = 0; t < NUM_THREADS; t++) {
+		workers.push_back(std::thread([&ss]() {
+			for (int key = 1; key < NUM_THREADS * PER_THREAD; key += 2) {
+				ss.delete_key(key);
+			}
+		}));
+	}
+	for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+	printf("after deletion: %zu\n", ss.size());
+	assert(ss.size() == NUM_THREADS * PER_THREAD / 2);
+
+	printf("range scan [100, 120):\n");
+	for (ConcurrentSkipList<int, int>::iterator it = ss.lower_bound(99);
+			it != ss.end() && it.key() < 120; ++it) {
+		printf("%d->%d\n", it.key(), it.value());
+	}
+
+	int last = -1;
+	size_t count = 0;
+	for (ConcurrentSkipList<int, int>::iterator it = ss.begin(); it != ss.end(); ++it) {
+		assert(it.key() > last && it.key() % 2 == 0);
+		last = it.key();
+		count++;
+	}
+	assert(count == ss.size());
+
+	try {
+		printf("get: %d->%d\n", 42, ss[42]);
+		printf("get: %d->%d\n", 43, ss[43]);
+	} catch (std::exception &e) {
+		printf("%s\n", e.what());
+	}
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "heap.h"
+#include "contraction_hierarchy.h"
+using namespace alg;
+
+/**
+ * the road grid, every block is a two way street, every tenth row &
+ * column is an avenue twice as fast.
+ */
+static void grid(uint32_t side, std::vector<WeightedEdge> & edges) {
+	for (uint32_t r = 0; r < side; r++) {
+		for (uint32_t c = 0; c < side; c++) {
+			uint32_t u = r * side + c;
+			if (c + 1 < side) {
+				int32_t fast = r % 10 == 0 ? 2 : 1;
+				WeightedEdge a = {u, u + 1, (10 + rand() % 90) / fast}, b = {u + 1, u, (10 + rand() % 90) / fast};
+				edges.push_back(a);
+				edges.push_back(b);
+			}
+			if (r + 1 < side) {
+				int32_t fast = c % 10 == 0 ? 2 : 1;
+				WeightedEdge a = {u, u + side, (10 + rand() % 90) / fast}, b = {u + side, u, (10 + rand() % 90) / fast};
+				edges.push_back(a);
+				edges.push_back(b);
+			}
+		}
+	}
+}
+
+/**
+ * what a query costs without an index: a Dijkstra over the whole graph
+ */
+static int64_t dijkstra(const CSRGraph & g, uint32_t s, uint32_t t) {
+	std::vector<int64_t> dist(g.vertex_count(), CH_INF);
+	IndexedHeap<int64_t> Q(g.vertex_count());
+	dist[s] = 0;
+	Q.push(s, 0);
+	while (!Q.is_empty()) {
+		uint32_t u = Q.pop();
+		for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+			uint32_t v = g.target(e);
+			if (dist[u] + g.weight(e) < dist[v]) {
+				dist[v] = dist[u] + g.weight(e);
+				Q.push(v, dist[v]);
+			}
+		}
+	}
+	return dist[t];
+}
+
+int main(void)
+{
+	srand(time(NULL));
+
+	const uint32_t SIDE = 300;
+	std::vector<WeightedEdge> edges;
+	grid(SIDE, edges);
+	CSRGraph g(SIDE * SIDE, &edges[0], (uint32_t)edges.size());
+	printf("road grid V=%u E=%u\n", g.vertex_count(), g.edge_count());
+
+	clock_t c = clock();
+	ContractionHierarchy ch(g);
+	printf("preprocessing %.2fs, %u arcs in the index (%u edges)\n",
+			(double)(clock() - c) / CLOCKS_PER_SEC, ch.arc_count(), g.edge_count());
+
+	// the index is built once & shipped to the routing servers
+	FILE * fp = tmpfile();
+	ch.save(fp);
+	printf("serialized index: %.1f MB\n", ftell(fp) / 1048576.0);
+	rewind(fp);
+	ContractionHierarchy loaded;
+	if (!loaded.load(fp)) {
+		printf("bad index\n");
+		return 1;
+	}
+	fclose(fp);
+
+	CHQuery q(loaded);
+	const int DIJKSTRA = 20, QUERIES = 100000;
+	c = clock();
+	for (int i = 0; i < DIJKSTRA; i++) {
+		uint32_t s = rand() % g.vertex_count(), t = rand() % g.vertex_count();
+		if (dijkstra(g, s, t) != q.distance(s, t)) {
+			printf("mismatch %u -> %u\n", s, t);
+			return 1;
+		}
+	}
+	double dij = (double)(clock() - c) / CLOCKS_PER_SEC / DIJKSTRA;
+
+	uint64_t settled = 0;
+	c = clock();
+	for (int i = 0; i < QUERIES; i++) {
+		q.distance(rand() % g.vertex_count(), rand() % g.vertex_count());
+		settled += q.settled();
+	}
+	double query = (double)(clock() - c) / CLOCKS_PER_SEC / QUERIES;
+	printf("point to point: Dijkstra %.1fms, CH query %.1fus (%.0f vertices settled)\n",
+			dij * 1e3, query * 1e6, (double)settled / QUERIES);
+
+	std::vector<uint32_t> path;
+	uint32_t s = 0, t = SIDE * SIDE - 1;
+	q.path(s, t, path);
+	printf("corner to corner: %lld over %u streets\n", (long long)q.distance(s, t), (uint32_t)path.size() - 1);
+	return 0;
+}
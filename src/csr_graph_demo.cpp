@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "csr_graph.h"
+#include "scc.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// a text edge list with scattered vertex ids
+	const uint32_t N = 1000000, M = 5000000;
+	const char * text = "/tmp/csr_graph_demo.txt", * bin = "/tmp/csr_graph_demo.csr";
+	FILE * fp = fopen(text, "w");
+	if (!fp) return 1;
+	fprintf(fp, "# u v weight\n");
+	for (uint32_t i = 0; i < M; i++) {
+		fprintf(fp, "%u %u %d\n", (rand() % N) * 37 + 11, (rand() % N) * 37 + 11, rand() % 1000);
+	}
+	fclose(fp);
+
+	double t = now();
+	CSRGraph g;
+	fp = fopen(text, "r");
+	bool ok = g.load_edge_list(fp);
+	fclose(fp);
+	if (!ok) return 1;
+	printf("edge list V=%u E=%u: parsed in %.2fs\n", g.vertex_count(), g.edge_count(), now() - t);
+
+	fp = fopen(bin, "wb");
+	ok = g.save(fp);
+	fclose(fp);
+	if (!ok) return 1;
+
+	t = now();
+	CSRGraph loaded;
+	fp = fopen(bin, "rb");
+	ok = loaded.load(fp);
+	fclose(fp);
+	printf("binary file read in %.3fs\n", now() - t);
+
+	t = now();
+	CSRGraph mapped;
+	ok = ok && mapped.map(bin);
+	printf("binary file mapped in %.6fs\n", now() - t);
+	if (!ok) return 1;
+
+	std::vector<uint32_t> comp;
+	t = now();
+	uint32_t k = tarjan_scc(mapped, comp);
+	printf("SCC on the mapped graph: %u components, %.2fs (pages read on the way)\n", k, now() - t);
+	printf("vertex id %u has %u out-edges\n", mapped.id(0), mapped.degree(0));
+
+	remove(text);
+	remove(bin);
+	return 0;
+}
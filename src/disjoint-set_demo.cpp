@@ -1,6 +1,10 @@
 #include <disjoint-set.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 int main(void) {
 	alg::Set<int> s1;
@@ -16,4 +20,36 @@ int main(void) {
 	alg::Union(&s1, &s2);
 	std::cout<< alg::FindSet(&s1) << std::endl;
 	std::cout<< alg::FindSet(&s2) << std::endl;
+
+	// connected components over a random graph
+	const uint32_t N = 1000000;
+	const uint32_t M = 800000;
+	std::vector<uint32_t> eu(M), ev(M);
+	for (uint32_t i = 0; i < M; i++) {
+		eu[i] = rand() % N;
+		ev[i] = rand() % N;
+	}
+
+	alg::DisjointSet ds(N);
+	for (uint32_t i = 0; i < M; i++) ds.unite(eu[i], ev[i]);
+	printf("components (sequential): %u\n", ds.count());
+
+	// the same edges, split across threads
+	const int THREADS = 4;
+	alg::ConcurrentDisjointSet cds(N);
+	std::vector<std::thread> workers;
+	for (int t = 0; t < THREADS; t++) {
+		workers.push_back(std::thread([&, t]() {
+			for (uint32_t i = t; i < M; i += THREADS) cds.unite(eu[i], ev[i]);
+		}));
+	}
+	for (int t = 0; t < THREADS; t++) workers[t].join();
+	printf("components (concurrent): %u\n", cds.count());
+	assert(ds.count() == cds.count());
+
+	for (uint32_t i = 0; i < 1000; i++) {
+		uint32_t a = rand() % N, b = rand() % N;
+		assert(ds.same(a, b) == cds.same(a, b));
+	}
+	return 0;
 }
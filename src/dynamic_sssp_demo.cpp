@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "dynamic_sssp.h"
+#include "dijkstra.h"
+using namespace alg;
+
+/**
+ * the road grid, every block is a two way street
+ */
+static void grid(uint32_t side, std::vector<WeightedEdge> & edges) {
+	for (uint32_t r = 0; r < side; r++) {
+		for (uint32_t c = 0; c < side; c++) {
+			uint32_t u = r * side + c;
+			if (c + 1 < side) {
+				WeightedEdge a = {u, u + 1, 10 + rand() % 90}, b = {u + 1, u, 10 + rand() % 90};
+				edges.push_back(a);
+				edges.push_back(b);
+			}
+			if (r + 1 < side) {
+				WeightedEdge a = {u, u + side, 10 + rand() % 90}, b = {u + side, u, 10 + rand() % 90};
+				edges.push_back(a);
+				edges.push_back(b);
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	srand(time(NULL));
+
+	DynamicSSSP small(5, 0);
+	small.add_edge(0, 1, 10);
+	small.add_edge(0, 3, 5);
+	small.add_edge(1, 2, 1);
+	small.add_edge(3, 1, 3);
+	small.add_edge(3, 2, 9);
+	small.add_edge(2, 4, 4);
+	small.update();
+	printf("distance to 4: %lld\n", (long long)small.dist(4));
+	small.set_weight(3, 1, 8);
+	small.delete_edge(1, 2);
+	small.update();
+	std::vector<uint32_t> path;
+	small.path(4, path);
+	printf("after 3->1 got slower & 1->2 closed: %lld via", (long long)small.dist(4));
+	for (size_t i = 0; i < path.size(); i++) printf(" %u", path[i]);
+	printf("\n");
+
+	const uint32_t SIDE = 500;
+	std::vector<WeightedEdge> edges;
+	grid(SIDE, edges);
+	CSRGraph g(SIDE * SIDE, &edges[0], (uint32_t)edges.size());
+	clock_t c = clock();
+	DynamicSSSP roads(g, 0);
+	double full = (double)(clock() - c) / CLOCKS_PER_SEC;
+	printf("road grid V=%u E=%u: from scratch %.3fs\n", g.vertex_count(), g.edge_count(), full);
+
+	// traffic: every second a handful of streets change their travel time.
+	// weight[i] follows edges[i], -1 while it is closed.
+	std::vector<int32_t> weight(edges.size());
+	for (size_t i = 0; i < edges.size(); i++) weight[i] = edges[i].weight;
+	const int SECONDS = 1000;
+	uint64_t settled = 0;
+	c = clock();
+	for (int s = 0; s < SECONDS; s++) {
+		for (int k = 0; k < 10; k++) {
+			size_t i = rand() % edges.size();
+			int32_t w = 10 + rand() % 90;
+			if (roads.set_weight(edges[i].u, edges[i].v, w)) weight[i] = w;
+		}
+		if (s % 100 == 0) {
+			size_t i = rand() % edges.size();
+			const WeightedEdge & e = edges[i];
+			if (roads.delete_edge(e.u, e.v)) {
+				weight[i] = -1;
+			} else {
+				roads.add_edge(e.u, e.v, e.weight);
+				weight[i] = e.weight;
+			}
+		}
+		settled += roads.update();
+	}
+	double inc = (double)(clock() - c) / CLOCKS_PER_SEC;
+	printf("%d updates of 10 streets: %.3fms each, %.0f vertices settled again on average\n",
+			SECONDS, inc * 1e3 / SECONDS, (double)settled / SECONDS);
+
+	// the repaired distances against Dijkstra on the streets as they are now
+	std::vector<WeightedEdge> now;
+	for (size_t i = 0; i < edges.size(); i++) {
+		if (weight[i] < 0) continue;
+		WeightedEdge e = {edges[i].u, edges[i].v, weight[i]};
+		now.push_back(e);
+	}
+	std::vector<int64_t> dist;
+	Dijkstra::run(CSRGraph(SIDE * SIDE, &now[0], (uint32_t)now.size()), 0, dist);
+	uint32_t wrong = 0;
+	for (uint32_t v = 0; v < SIDE * SIDE; v++) {
+		if (roads.dist(v) != dist[v]) wrong++;
+	}
+	printf("against Dijkstra from scratch: %s\n", wrong ? "DIFFERENT" : "same distances");
+	if (wrong) return 1;
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+#include <algorithm>
+#include "eytzinger.h"
+
+using namespace alg;
+
+int main()
+{
+	const uint32_t N = 1 << 20;
+	const uint32_t Q = 1 << 22;
+
+	int * keys = new int[N];
+	int * values = new int[N];
+	srand(time(NULL));
+	for (uint32_t i = 0; i < N; i++) keys[i] = rand();
+	std::sort(keys, keys + N);
+	for (uint32_t i = 0; i < N; i++) values[i] = i;
+
+	Eytzinger<int, int> et(keys, values, N);
+
+	int * queries = new int[Q];
+	for (uint32_t i = 0; i < Q; i++) {
+		queries[i] = (i & 1) ? keys[rand() % N] : rand();
+	}
+
+	// verify against std::lower_bound
+	for (uint32_t i = 0; i < 100000; i++) {
+		int * p = std::lower_bound(keys, keys + N, queries[i]);
+		uint32_t slot = et.lower_bound(queries[i]);
+		if (p == keys + N) assert(slot == 0);
+		else assert(slot != 0 && et.key(slot) == *p);
+	}
+
+	long sum = 0;
+	clock_t t = clock();
+	for (uint32_t i = 0; i < Q; i++) {
+		sum += std::lower_bound(keys, keys + N, queries[i]) - keys;
+	}
+	printf("std::lower_bound: %.3fs (%ld)\n", (double)(clock() - t) / CLOCKS_PER_SEC, sum);
+
+	sum = 0;
+	t = clock();
+	for (uint32_t i = 0; i < Q; i++) {
+		int v;
+		if (et.find(queries[i], v)) sum += v;
+	}
+	printf("Eytzinger::find: %.3fs (%ld)\n", (double)(clock() - t) / CLOCKS_PER_SEC, sum);
+
+	int * results = new int[Q];
+	bool * found = new bool[Q];
+	long sum2 = 0;
+	t = clock();
+	et.find_batch(queries, Q, results, found);
+	for (uint32_t i = 0; i < Q; i++) {
+		if (found[i]) sum2 += results[i];
+	}
+	printf("Eytzinger::find_batch: %.3fs (%ld)\n", (double)(clock() - t) / CLOCKS_PER_SEC, sum2);
+	assert(sum == sum2);
+
+	delete [] keys;
+	delete [] values;
+	delete [] queries;
+	delete [] results;
+	delete [] found;
+	return 0;
+}
@@ -1,4 +1,8 @@
 #include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <cassert>
+#include <stdint.h>
 #include "fenwick_tree.h"
 
 int main()
@@ -12,5 +16,57 @@ int main()
 
 	ft.update(1, 5);	
 	printf("%d\n", ft.rsq(1));
+
+	// O(n) construction over doubles
+	double a[] = {0.5, 1.5, 2.5, 3.5, 4.5};
+	BasicFenwick<double> fd(a, 5);
+	printf("sum 2..4: %.1f\n", fd.rsq(2, 4));
+
+	// range update & range query
+	RangeFenwick<int64_t> rf(10);
+	rf.update(2, 5, 3);
+	rf.update(4, 10, 1);
+	printf("sum 1..10: %lld, sum 4..5: %lld\n", (long long)rf.rsq(1, 10), (long long)rf.rsq(4, 5));
+	assert(rf.rsq(1, 10) == 4 * 3 + 7 && rf.rsq(4, 5) == 8);
+
+	// 2D
+	Fenwick2D<int> f2(4, 4);
+	f2.update(1, 1, 1);
+	f2.update(2, 3, 5);
+	f2.update(4, 4, 7);
+	printf("sum (2,2)..(4,4): %d\n", f2.rsq(2, 2, 4, 4));
+	assert(f2.rsq(2, 2, 4, 4) == 12);
+
+	// Fenwick vs block prefix sums on counters
+	const int N = 1 << 20;
+	const int OPS = 1 << 22;
+	int64_t * init = new int64_t[N];
+	int * keys = new int[OPS];
+	for(int i = 0; i < N; i++) init[i] = rand() % 100;
+	for(int i = 0; i < OPS; i++) keys[i] = rand() % N + 1;
+	BasicFenwick<int64_t> fen(init, N);
+	BlockPrefixSum<int64_t> bps(init, N);
+
+	// one update per three queries
+	int64_t s1 = 0, s2 = 0;
+	clock_t t = clock();
+	for(int i = 0; i < OPS; i++) {
+		if(i % 4 == 0) fen.update(keys[i], 1);
+		else s1 += fen.rsq(keys[i]);
+	}
+	printf("Fenwick: %.3fs\n", (double)(clock() - t) / CLOCKS_PER_SEC);
+
+	t = clock();
+	for(int i = 0; i < OPS; i++) {
+		if(i % 4 == 0) bps.update(keys[i], 1);
+		else s2 += bps.rsq(keys[i]);
+	}
+	printf("BlockPrefixSum: %.3fs\n", (double)(clock() - t) / CLOCKS_PER_SEC);
+	assert(s1 == s2);
+	for(int k = 1; k <= N; k += 997)
+		assert(fen.rsq(k) == bps.rsq(k));
+
+	delete [] init;
+	delete [] keys;
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "floyd_warshall.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+/**
+ * the textbook triple loop, for comparison
+ */
+static void floyd_warshall_naive(Array2D<int32_t> & d) {
+	uint32_t n = d.row();
+	for (uint32_t k = 0; k < n; k++) {
+		for (uint32_t i = 0; i < n; i++) {
+			for (uint32_t j = 0; j < n; j++) {
+				if (d(i, k) + d(k, j) < d(i, j)) d(i, j) = d(i, k) + d(k, j);
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// a few negative weights, no negative cycle: every edge u->v with
+	// u > v is non negative, and the others at least -5 with a long way back
+	const uint32_t N = 1500, M = 8 * N;
+	std::vector<WeightedEdge> edges(M);
+	for (uint32_t i = 0; i < M; i++) {
+		edges[i].u = rand() % N;
+		edges[i].v = rand() % N;
+		edges[i].weight = edges[i].u < edges[i].v ? rand() % 100 - 5 : 50 + rand() % 100;
+	}
+	CSRGraph g(N, &edges[0], M);
+	printf("V=%u E=%u\n", N, M);
+
+	Array2D<int32_t> naive(N, N), blocked(N, N), sparse(N, N);
+	adjacency_matrix(g, naive);
+	adjacency_matrix(g, blocked);
+
+	double t = now();
+	floyd_warshall_naive(naive);
+	printf("naive Floyd-Warshall:   %.2fs\n", now() - t);
+
+	t = now();
+	bool ok = floyd_warshall(blocked);
+	printf("blocked Floyd-Warshall: %.2fs%s\n", now() - t, ok ? "" : " negative cycle");
+
+	t = now();
+	ok = johnson(g, sparse);
+	printf("Johnson:                %.2fs%s\n", now() - t, ok ? "" : " negative cycle");
+
+	uint32_t diff = 0;
+	for (uint32_t i = 0; i < N; i++) {
+		for (uint32_t j = 0; j < N; j++) {
+			int32_t d = naive(i, j) >= FW_INF / 2 ? FW_INF : naive(i, j);
+			diff += d != blocked(i, j) || d != sparse(i, j);
+		}
+	}
+	printf("%u differences, d(0, %u) = %d\n", diff, N - 1, blocked(0, N - 1));
+	if (diff != 0) return 1;
+	return 0;
+}
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "fm_index.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// 16MB of log lines
+	const char * level[] = {"INFO", "WARN", "ERROR", "DEBUG"};
+	const char * what[] = {"connection accepted", "request served", "cache miss", "timeout", "retrying"};
+	std::string text;
+	while (text.size() < (16 << 20)) {
+		char line[128];
+		snprintf(line, sizeof(line), "2024-01-%02d %s [worker-%d] %s id=%d\n", 1 + rand() % 28,
+				level[rand() % 4], rand() % 64, what[rand() % 5], rand() % 100000);
+		text += line;
+	}
+
+	double t = now();
+	FMIndex fm(text, 32);
+	printf("indexed %.1fMB in %.2fs, index %.1fMB (text & suffix array: %.1fMB)\n", text.size() / 1048576.0,
+			now() - t, fm.bytes() / 1048576.0, text.size() * 5 / 1048576.0);
+
+	const char * path = "/tmp/fm_index_demo.fmi";
+	FILE * fp = fopen(path, "wb");
+	bool ok = fp && fm.save(fp);
+	if (fp) fclose(fp);
+	FMIndex loaded;
+	fp = fopen(path, "rb");
+	ok = ok && fp && loaded.load(fp);
+	if (fp) fclose(fp);
+	remove(path);
+	if (!ok) return 1;
+	printf("saved & loaded back\n");
+
+	const char * patterns[] = {"ERROR [worker-7]", "timeout id=4242", "cache miss", "no such line"};
+	for (int i = 0; i < 4; i++) {
+		std::string p = patterns[i];
+		t = now();
+		uint64_t n = loaded.count(p);
+		double t_count = now() - t;
+
+		std::vector<uint64_t> pos;
+		t = now();
+		loaded.locate(p, pos);
+		double t_locate = now() - t;
+
+		// a scan of the text, to compare
+		t = now();
+		uint64_t scan = 0;
+		for (const char * s = text.c_str(); (s = strstr(s, p.c_str())) != NULL; s++) scan++;
+		double t_scan = now() - t;
+
+		printf("\"%s\": %llu (scan %llu), count %.6fs, locate %.4fs, scan %.4fs\n", p.c_str(),
+				(unsigned long long)n, (unsigned long long)scan, t_count, t_locate, t_scan);
+		if (!pos.empty()) printf("  first at %llu\n", (unsigned long long)pos[0]);
+	}
+	return 0;
+}
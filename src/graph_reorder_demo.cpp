@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "csr_graph.h"
+#include "graph_reorder.h"
+#include "dijkstra.h"
+#include "pagerank.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+// BFS from s, the sum of the levels
+static uint64_t bfs(const CSRGraph & g, uint32_t s) {
+	std::vector<uint32_t> level(g.vertex_count(), UINT32_MAX), queue;
+	queue.reserve(g.vertex_count());
+	queue.push_back(s);
+	level[s] = 0;
+	uint64_t sum = 0;
+	for (size_t head = 0; head < queue.size(); head++) {
+		uint32_t u = queue[head];
+		sum += level[u];
+		for (uint32_t e = g.begin(u); e < g.end(u); e++) {
+			uint32_t v = g.target(e);
+			if (level[v] == UINT32_MAX) {
+				level[v] = level[u] + 1;
+				queue.push_back(v);
+			}
+		}
+	}
+	return sum;
+}
+
+static void bench(const char * name, const CSRGraph & g, const std::vector<uint32_t> & perm, uint32_t s) {
+	double t = now();
+	CSRGraph h = perm.empty() ? g : g.permute(perm);
+	double relabel = now() - t;
+	if (!perm.empty()) s = perm[s];
+
+	// the mean gap between the ends of an edge
+	double gap = 0;
+	for (uint32_t u = 0; u < h.vertex_count(); u++) {
+		for (uint32_t e = h.begin(u); e < h.end(u); e++) gap += abs((int)h.target(e) - (int)u);
+	}
+	gap /= h.edge_count();
+
+	t = now();
+	uint64_t levels = 0;
+	for (int i = 0; i < 5; i++) levels += bfs(h, s);
+	double t_bfs = (now() - t) / 5;
+
+	std::vector<int64_t> dist;
+	t = now();
+	Dijkstra::run(h, s, dist);
+	double t_dij = now() - t;
+	int64_t total = 0;
+	for (uint32_t v = 0; v < h.vertex_count(); v++) total += dist[v] == DIJKSTRA_INF ? 0 : dist[v];
+
+	std::vector<double> rank;
+	PageRank pr(h, 1);
+	t = now();
+	pr.run(rank, 0.85, 0, 10);
+	double t_pr = (now() - t) / 10;
+
+	printf("%-9s %9.0f %9.3f %9.3f %9.3f %11.3f   (check %llu %lld)\n", name, gap, relabel, t_bfs, t_dij, t_pr,
+			(unsigned long long)levels / 5, (long long)total);
+}
+
+static void run(const char * title, const CSRGraph & g) {
+	printf("\n%s: V=%u E=%u\n", title, g.vertex_count(), g.edge_count());
+	printf("%-9s %9s %9s %9s %9s %11s\n", "order", "edge gap", "relabel", "BFS", "Dijkstra", "PR/iter");
+	std::vector<uint32_t> perm;
+	bench("given", g, perm, 0);
+	double t = now();
+	rcm_order(g, perm);
+	printf("  (RCM order in %.2fs)\n", now() - t);
+	bench("RCM", g, perm, 0);
+	degree_order(g, perm);
+	bench("degree", g, perm, 0);
+	bfs_order(g, perm);
+	bench("BFS", g, perm, 0);
+}
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// a 1000x1000 grid, both ways, under shuffled vertex ids
+	const uint32_t W = 1000, N = W * W;
+	std::vector<uint32_t> label(N);
+	for (uint32_t i = 0; i < N; i++) label[i] = i;
+	for (uint32_t i = N - 1; i > 0; i--) std::swap(label[i], label[rand() % (i + 1)]);
+	std::vector<WeightedEdge> edges;
+	for (uint32_t r = 0; r < W; r++) {
+		for (uint32_t c = 0; c < W; c++) {
+			uint32_t u = label[r * W + c];
+			if (c + 1 < W) {
+				WeightedEdge e = {u, label[r * W + c + 1], 1 + rand() % 100};
+				edges.push_back(e);
+			}
+			if (r + 1 < W) {
+				WeightedEdge e = {u, label[(r + 1) * W + c], 1 + rand() % 100};
+				edges.push_back(e);
+			}
+		}
+	}
+	run("shuffled grid", CSRGraph(N, &edges[0], (uint32_t)edges.size(), true));
+
+	// a skewed graph: a few hubs get most of the edges
+	const uint32_t M = 8000000;
+	edges.resize(M);
+	for (uint32_t i = 0; i < M; i++) {
+		uint32_t r = rand() % N;
+		edges[i].u = rand() % N;
+		edges[i].v = label[(uint32_t)((uint64_t)r * r / N)];
+		edges[i].weight = 1 + rand() % 100;
+	}
+	run("skewed graph", CSRGraph(N, &edges[0], M));
+	return 0;
+}
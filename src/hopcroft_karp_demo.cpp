@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "hopcroft_karp.h"
+using namespace alg;
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// 5 workers, 5 jobs
+	HopcroftKarp small(5, 5);
+	small.add_edge(0, 0);
+	small.add_edge(0, 1);
+	small.add_edge(1, 0);
+	small.add_edge(2, 1);
+	small.add_edge(2, 2);
+	small.add_edge(3, 2);
+	small.add_edge(3, 3);
+	small.add_edge(4, 3);
+	printf("maximum matching: %u\n", small.run());
+	for (uint32_t l = 0; l < 5; l++) {
+		if (small.mate_left(l) != HopcroftKarp::NONE) printf("worker %u -> job %u\n", l, small.mate_left(l));
+		else printf("worker %u -> none\n", l);
+	}
+
+	// a random instance with 1M vertices
+	const uint32_t SIDE = 500000;
+	HopcroftKarp hk(SIDE, SIDE);
+	for (uint32_t l = 0; l < SIDE; l++) {
+		for (int k = 0; k < 3; k++) hk.add_edge(l, rand() % SIDE);
+	}
+	clock_t c = clock();
+	uint32_t m = hk.run();
+	printf("random V=%u E=%u: matching %u, %.3fs\n", 2 * SIDE, 3 * SIDE, m,
+			(double)(clock() - c) / CLOCKS_PER_SEC);
+	return 0;
+}
@@ -20,6 +20,14 @@ int main() {
     }
 
 	t.print();
+
+	std::vector<IntervalTree::ivltree_node> all;
+	t.stab(50, all);
+	printf("intervals containing %d:\n", 50);
+	for(i=0; i<(int)all.size(); i++) {
+		printf("[%d %d]\n", all[i]->low, all[i]->high);
+	}
+
 	printf("search interval: [%d %d]\n", 5, 10);
 	
     int low = 5;
@@ -34,6 +42,20 @@ int main() {
     }
 	t.print();
 
+	// time windows with payloads, bulk built for read-heavy use
+	int64_t starts[] = {1000, 1500, 1200, 3000, 2500};
+	int64_t ends[]   = {2000, 1600, 2600, 4000, 2700};
+	int ids[]        = {0, 1, 2, 3, 4};
+	StaticIntervalTree<int64_t, int> st(starts, ends, ids, 5);
+	std::vector<uint32_t> hits;
+	st.overlaps(1550, 2550, hits);
+	printf("windows overlapping [1550 2550]:\n");
+	for(i=0; i<(int)hits.size(); i++) {
+		printf("#%d [%lld %lld]\n", st.payload(hits[i]),
+				(long long)st.interval(hits[i]).low, (long long)st.interval(hits[i]).high);
+	}
+	assert(hits.size() == 4);
+
     return 0;
 }
 
@@ -1,7 +1,8 @@
 #include <stdio.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <vector>
+#include <chrono>
 
 #include "undirected_graph.h"
 #include "kruskal_mst.h"
@@ -24,6 +25,34 @@ int main(void)
 	mst->printdot();
 	delete mst;
 	delete g;
+
+	// a large random graph as flat edge arrays
+	const uint32_t N = 200000, M = 2000000;
+	std::vector<WeightedEdge> edges(M);
+	for (uint32_t i = 0; i < M; i++) {
+		edges[i].u = rand() % N;
+		edges[i].v = rand() % N;
+		edges[i].weight = rand() % 100000 - 50000;
+	}
+
+	std::vector<WeightedEdge> e1(edges), e2(edges), t1, t2, t3;
+	typedef std::chrono::steady_clock clk;
+	clk::time_point c = clk::now();
+	int64_t w1 = kruskal_mst(N, &e1[0], M, t1);
+	printf("kruskal:         weight %lld, %u edges, %.3fs\n", (long long)w1, (uint32_t)t1.size(),
+			std::chrono::duration<double>(clk::now() - c).count());
+	c = clk::now();
+	int64_t w2 = filter_kruskal_mst(N, &e2[0], M, t2);
+	printf("filter-kruskal:  weight %lld, %u edges, %.3fs\n", (long long)w2, (uint32_t)t2.size(),
+			std::chrono::duration<double>(clk::now() - c).count());
+	c = clk::now();
+	int64_t w3 = boruvka_mst(N, &edges[0], M, t3);
+	printf("boruvka:         weight %lld, %u edges, %.3fs\n", (long long)w3, (uint32_t)t3.size(),
+			std::chrono::duration<double>(clk::now() - c).count());
+
+	if (w1 != w2 || w1 != w3 || t1.size() != t2.size() || t1.size() != t3.size()) {
+		printf("MISMATCH\n");
+		return 1;
+	}
 	return 0;
 }
-
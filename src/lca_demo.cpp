@@ -2,6 +2,9 @@
 #include <cstdio>
 #include <vector>
 #include <iostream>
+#include <cstdlib>
+#include <cassert>
+#include <algorithm>
 /**
 *Constructor is initialized with a Adjacency List that
 *describe a tree and If It doesn't describe a tree it asserts failure.
@@ -14,7 +17,7 @@ LCA::LCA(std::vector< std::pair<int,int> > edges): _numberOfNodes(edges.size() +
     nodeHeight.resize(_numberOfNodes);
     visited.resize(_numberOfNodes);
     adjList.resize(_numberOfNodes);
-    binaryLiftDp = std::vector< std::vector<int> >(_numberOfNodes, std::vector<int>(_maxLog));
+    binaryLiftDp = std::vector< std::vector<int> >(_numberOfNodes, std::vector<int>(_maxLog + 1));
     /**Construction of the Adjacency List to increase
     *The efficiency of the tree traversal to O(V + E).
     */
@@ -34,7 +37,7 @@ void LCA::dfs(int currentNode, int currentParent)
 {
     visited[currentNode] = true;
     parent[currentNode] = currentParent;
-    nodeHeight[currentNode] = nodeHeight[currentParent] + 1;
+    nodeHeight[currentNode] = currentParent == -1 ? 0 : nodeHeight[currentParent] + 1;
     int adjacencySize = adjList[currentNode].size();
     for(int idx = 0; idx < adjacencySize; idx++){
         int nextNode = adjList[currentNode][idx];
@@ -98,7 +101,7 @@ int LCA::lcaQuery(int a, int b)
     if(a == b) return a;
     for(int i = _maxLog; i >= 0; i--)
     {
-        if(binaryLiftDp[a][i] + 1 && binaryLiftDp[a][i] - binaryLiftDp[b][i])
+        if(binaryLiftDp[a][i] + 1 && binaryLiftDp[a][i] != binaryLiftDp[b][i])
             a = binaryLiftDp[a][i], b = binaryLiftDp[b][i];
     }
     return parent[a];
@@ -110,8 +113,31 @@ int main(){
     edges.push_back({1,2});
     edges.push_back({2,3});
     edges.push_back({1,4});
-    LCA* l = new LCA(v);
-    std::cout << l->lcaQuery(0,1) << endl;
-    std::cout << l->lcaQuery(3,4) << endl;
-    std::cout << l->lcaQuery(3,2) << endl;
+    LCA* l = new LCA(edges);
+    std::cout << l->lcaQuery(0,1) << std::endl;
+    std::cout << l->lcaQuery(3,4) << std::endl;
+    std::cout << l->lcaQuery(3,2) << std::endl;
+    delete l;
+
+    EulerTourLCA e(5, edges);
+    std::cout << e.lcaQuery(0,1) << std::endl;
+    std::cout << e.lcaQuery(3,4) << std::endl;
+    std::cout << e.lcaQuery(3,2) << std::endl;
+    std::cout << "distance(3,4): " << e.distance(3,4) << std::endl;
+
+    // a chain of one million nodes, far too deep for a recursive DFS
+    const int N = 1000000;
+    std::vector< std::pair<int,int> > chain;
+    for(int i = 1; i < N; i++) chain.push_back(std::make_pair(i - 1, i));
+    EulerTourLCA c(N, chain);
+
+    const int Q = 8;
+    int a[Q], b[Q], result[Q];
+    for(int i = 0; i < Q; i++) a[i] = rand() % N, b[i] = rand() % N;
+    c.lcaQuery(a, b, Q, result);
+    for(int i = 0; i < Q; i++) {
+        std::cout << "lca(" << a[i] << "," << b[i] << ") = " << result[i] << std::endl;
+        assert(result[i] == std::min(a[i], b[i]));
+    }
+    return 0;
 }
@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "max_flow.h"
+using namespace alg;
+
+struct CostEdge {
+	uint32_t u, v;
+	int64_t cap, cost;
+};
+
+/**
+ * the reference min-cost flow: successive shortest paths by Bellman-Ford,
+ * on an arc list with the reverse arc at index ^ 1
+ */
+static int64_t ssp_bellman_ford(uint32_t n, const std::vector<CostEdge> & edges, uint32_t s, uint32_t t, int64_t & cost)
+{
+	std::vector<CostEdge> arcs;
+	for (size_t i = 0; i < edges.size(); i++) {
+		CostEdge back = {edges[i].v, edges[i].u, 0, -edges[i].cost};
+		arcs.push_back(edges[i]);
+		arcs.push_back(back);
+	}
+	const int64_t INF = INT64_MAX;
+	int64_t flow = 0;
+	cost = 0;
+	for (;;) {
+		std::vector<int64_t> dist(n, INF);
+		std::vector<uint32_t> prev(n, FLOW_NIL);
+		dist[s] = 0;
+		for (uint32_t round = 0; round < n; round++) {
+			for (uint32_t a = 0; a < arcs.size(); a++) {
+				const CostEdge & e = arcs[a];
+				if (e.cap > 0 && dist[e.u] != INF && dist[e.u] + e.cost < dist[e.v]) {
+					dist[e.v] = dist[e.u] + e.cost;
+					prev[e.v] = a;
+				}
+			}
+		}
+		if (dist[t] == INF) return flow;
+		int64_t f = INF;
+		for (uint32_t v = t; v != s; v = arcs[prev[v]].u) f = std::min(f, arcs[prev[v]].cap);
+		for (uint32_t v = t; v != s; v = arcs[prev[v]].u) {
+			arcs[prev[v]].cap -= f;
+			arcs[prev[v] ^ 1].cap += f;
+			cost += f * arcs[prev[v]].cost;
+		}
+		flow += f;
+	}
+}
+
+int main(void)
+{
+	using namespace alg;
+	srand(time(NULL));
+
+	// a small network, with the flow on every edge
+	FlowNetwork small(6);
+	small.add_edge(0, 1, 16);
+	small.add_edge(0, 2, 13);
+	small.add_edge(1, 2, 10);
+	small.add_edge(2, 1, 4);
+	small.add_edge(1, 3, 12);
+	small.add_edge(3, 2, 9);
+	small.add_edge(2, 4, 14);
+	small.add_edge(4, 3, 7);
+	small.add_edge(3, 5, 20);
+	small.add_edge(4, 5, 4);
+	printf("Max Flow from 0 to 5 is %lld\n", (long long)Dinic(small).run(0, 5));
+	for (uint32_t e = 0; e < small.edge_count(); e++) {
+		printf("edge %u: flow %lld\n", e, (long long)small.flow(e));
+	}
+
+	// bipartite assignment: s -> 500000 workers -> 500000 jobs -> t
+	const uint32_t SIDE = 500000;
+	const uint32_t N = 2 * SIDE + 2;
+	const uint32_t s = 2 * SIDE, t = 2 * SIDE + 1;
+	FlowNetwork a(N), b(N);
+	for (uint32_t i = 0; i < SIDE; i++) {
+		a.add_edge(s, i, 1);
+		b.add_edge(s, i, 1);
+		a.add_edge(SIDE + i, t, 1);
+		b.add_edge(SIDE + i, t, 1);
+		for (int k = 0; k < 3; k++) {
+			uint32_t j = SIDE + rand() % SIDE;
+			a.add_edge(i, j, 1);
+			b.add_edge(i, j, 1);
+		}
+	}
+
+	clock_t c = clock();
+	int64_t f1 = Dinic(a).run(s, t);
+	double s1 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	c = clock();
+	int64_t f2 = PushRelabel(b).run(s, t);
+	double s2 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	printf("bipartite V=%u E=%u: dinic %lld %.3fs, push-relabel %lld %.3fs\n",
+			N, a.edge_count(), (long long)f1, s1, (long long)f2, s2);
+
+	// a random sparse network
+	const uint32_t RN = 200000;
+	FlowNetwork r1(RN), r2(RN);
+	for (uint32_t i = 0; i < RN * 5; i++) {
+		uint32_t u = rand() % RN, v = rand() % RN;
+		int64_t cap = rand() % 10000;
+		r1.add_edge(u, v, cap);
+		r2.add_edge(u, v, cap);
+	}
+	c = clock();
+	f1 = Dinic(r1).run(0, RN - 1);
+	s1 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	c = clock();
+	f2 = PushRelabel(r2).run(0, RN - 1);
+	s2 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	printf("random V=%u E=%u: dinic %lld %.3fs, push-relabel %lld %.3fs\n",
+			RN, r1.edge_count(), (long long)f1, s1, (long long)f2, s2);
+
+	if (f1 != f2) return 1;
+
+	// weighted assignment: 40000 tasks, 60000 workers, each task fits 5
+	// workers at a random cost
+	const uint32_t T = 40000, W = 60000;
+	FlowNetwork w(T + W + 2);
+	for (uint32_t i = 0; i < T; i++) {
+		w.add_edge(T + W, i, 1);
+		for (int k = 0; k < 5; k++) {
+			w.add_edge(i, T + rand() % W, 1, rand() % 1000);
+		}
+	}
+	for (uint32_t i = 0; i < W; i++) w.add_edge(T + i, T + W + 1, 1);
+	int64_t cost;
+	c = clock();
+	int64_t assigned = MinCostFlow(w).run(T + W, T + W + 1, cost);
+	printf("assignment V=%u E=%u: %lld assigned, total cost %lld, %.3fs\n",
+			T + W + 2, w.edge_count(), (long long)assigned, (long long)cost,
+			(double)(clock() - c) / CLOCKS_PER_SEC);
+
+	// a small assignment against the reference, the arc out of s with an
+	// "infinite" capacity
+	const uint32_t ST = 30, SW = 40, ss = ST + SW + 1, st = ST + SW + 2;
+	std::vector<CostEdge> edges;
+	CostEdge supply = {ss, ST + SW, (int64_t)1e18, 100};
+	edges.push_back(supply);
+	for (uint32_t i = 0; i < ST; i++) {
+		CostEdge e = {ST + SW, i, 1, 0};
+		edges.push_back(e);
+		for (int k = 0; k < 4; k++) {
+			CostEdge x = {i, ST + rand() % SW, 1, rand() % 1000};
+			edges.push_back(x);
+		}
+	}
+	for (uint32_t i = 0; i < SW; i++) {
+		CostEdge e = {ST + i, st, (int64_t)1e18, 0};
+		edges.push_back(e);
+	}
+	FlowNetwork sm(ST + SW + 3);
+	for (size_t i = 0; i < edges.size(); i++) sm.add_edge(edges[i].u, edges[i].v, edges[i].cap, edges[i].cost);
+	int64_t ref_cost;
+	assigned = MinCostFlow(sm).run(ss, st, cost);
+	int64_t ref = ssp_bellman_ford(ST + SW + 3, edges, ss, st, ref_cost);
+	printf("small assignment: %lld assigned, cost %lld, reference %lld at %lld, %s\n",
+			(long long)assigned, (long long)cost, (long long)ref, (long long)ref_cost,
+			assigned == ref && cost == ref_cost ? "same" : "DIFFERENT");
+	if (assigned != ref || cost != ref_cost) return 1;
+	return 0;
+}
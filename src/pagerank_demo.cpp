@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "csr_graph.h"
+#include "pagerank.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// a skewed random graph: the targets lean towards the low ids
+	const uint32_t N = 1000000, M = 8000000;
+	std::vector<WeightedEdge> edges(M);
+	for (uint32_t i = 0; i < M; i++) {
+		uint32_t r = rand() % N;
+		edges[i].u = rand() % N;
+		edges[i].v = (uint32_t)((uint64_t)r * r / N);
+		edges[i].weight = 1;
+	}
+	CSRGraph g(N, &edges[0], M);
+
+	double t = now();
+	PageRank pr(g);
+	printf("V=%u E=%u, transposed in %.2fs\n", g.vertex_count(), g.edge_count(), now() - t);
+
+	std::vector<double> rank;
+	t = now();
+	uint32_t iter = pr.run(rank);
+	printf("PageRank: %u iterations, %.2fs\n", iter, now() - t);
+	for (uint32_t v = 0; v < 5; v++) printf("  rank(%u) = %.6f\n", v, rank[v]);
+
+	std::vector<uint32_t> seeds;
+	seeds.push_back(N - 1);
+	seeds.push_back(N / 2);
+	t = now();
+	iter = pr.run_personalized(seeds, rank);
+	printf("personalized to %u & %u: %u iterations, %.2fs\n", seeds[0], seeds[1], iter, now() - t);
+	for (uint32_t v = 0; v < 3; v++) printf("  rank(%u) = %.6f\n", v, rank[v]);
+	printf("  rank(%u) = %.6f\n", seeds[0], rank[seeds[0]]);
+	return 0;
+}
@@ -2,10 +2,43 @@
 #include <stdio.h>
 #include <stdlib.h> 
 #include <time.h>
+#include <vector>
 
 #include "undirected_graph.h"
 #include "prim_mst.h"
 
+using namespace alg;
+
+static void bench(const char * name, uint32_t n, uint32_t m) {
+	std::vector<WeightedEdge> edges(m);
+	for (uint32_t i = 0; i < m; i++) {
+		edges[i].u = rand() % n;
+		edges[i].v = rand() % n;
+		edges[i].weight = rand() % 100000;
+	}
+	CSRGraph g(n, &edges[0], m, true);
+	Array2D<int32_t> w(n, n);
+	w.clear(INT32_MAX);
+	for (uint32_t i = 0; i < m; i++) {
+		int32_t c = edges[i].weight;
+		if (c < w(edges[i].u, edges[i].v)) w(edges[i].u, edges[i].v) = w(edges[i].v, edges[i].u) = c;
+	}
+
+	std::vector<uint32_t> parent;
+	std::vector<int32_t> weight;
+	clock_t c = clock();
+	long long t1 = prim_mst(g, 0, parent, weight);
+	double s1 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	c = clock();
+	long long t2 = prim_mst_lazy(g, 0, parent, weight);
+	double s2 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	c = clock();
+	long long t3 = prim_mst_dense(w, 0, parent, weight);
+	double s3 = (double)(clock() - c) / CLOCKS_PER_SEC;
+	printf("%s V=%u E=%u: eager %lld %.3fs, lazy %lld %.3fs, dense %lld %.3fs\n",
+			name, n, m, t1, s1, t2, s2, t3, s3);
+}
+
 int main(void)
 {
 	using namespace alg;
@@ -18,5 +51,8 @@ int main(void)
 	prim->printdot();
 	delete prim;
 	delete g;
+
+	bench("sparse", 4000, 16000);
+	bench("dense ", 2000, 2000000);
 	return 0;	
 }
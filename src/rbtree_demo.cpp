@@ -43,7 +43,7 @@ int main() {
 
 	srand(time(NULL));
 
-	int MAXELEMENT = 50;
+	const int MAXELEMENT = 50;
 	printf("Inserting: \t");
     for(i=0; i<MAXELEMENT; i++) {
         int key  = i;
@@ -65,6 +65,34 @@ int main() {
 
 	printf("\n");
 	t.print();
+
+	// augmented with the sum of values, for rank/select & range-sum
+	RBTree<int,int,RBTreeSum<int,int> > s;
+	for(i=0; i<MAXELEMENT; i++) {
+		s.insert(i * 2, i);
+	}
+	int sum;
+	s.aggregate(10, 20, sum);
+	printf("\nsum of keys in [10, 20]: %d\n", sum);
+	printf("rank of key 15: %u\n", s.rank(15));
+	printf("the 10th smallest key: %d\n", s.select(10));
+	assert(sum == 5+6+7+8+9+10);
+	assert(s.rank(15) == 8);
+	assert(s.select(10) == 20);
+
+	// bulk construction from sorted keys in O(n)
+	int keys[MAXELEMENT], values[MAXELEMENT];
+	for(i=0; i<MAXELEMENT; i++) {
+		keys[i] = i;
+		values[i] = i * i;
+	}
+	RBTree<int,int> b;
+	b.build_from_sorted(keys, values, MAXELEMENT);
+	printf("\nbulk built:\n");
+	b.print();
+	for(i=0; i<MAXELEMENT; i++) {
+		assert(b[i] == i * i);
+	}
     return 0;
 }
 
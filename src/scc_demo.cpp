@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h> 
 #include <time.h>
+#include <vector>
+#include <chrono>
 
 #include "directed_graph.h"
 #include "graph_search.h"
@@ -41,5 +43,40 @@ int main()
 	SCC(*g);
 
 	delete g;
+
+	// a long chain of 2-cycles, then a random graph, as flat arrays
+	typedef std::chrono::steady_clock clk;
+	const uint32_t N = 4000000;
+	for (int kind = 0; kind < 2; kind++) {
+		std::vector<WeightedEdge> edges;
+		for (uint32_t u = 0; u < N; u++) {
+			if (kind == 0) {
+				if (u + 1 < N) {
+					WeightedEdge e = {u, u + 1, 1};
+					edges.push_back(e);
+				}
+				if (u & 1) {
+					WeightedEdge e = {u, u - 1, 1};
+					edges.push_back(e);
+				}
+			} else {
+				for (int k = 0; k < 3; k++) {
+					WeightedEdge e = {u, (uint32_t)(rand() % N), 1};
+					edges.push_back(e);
+				}
+			}
+		}
+		CSRGraph csr(N, &edges[0], (uint32_t)edges.size());
+
+		std::vector<uint32_t> comp;
+		clk::time_point t = clk::now();
+		uint32_t k1 = tarjan_scc(csr, comp);
+		double s1 = std::chrono::duration<double>(clk::now() - t).count();
+		t = clk::now();
+		uint32_t k2 = parallel_scc(csr, comp);
+		double s2 = std::chrono::duration<double>(clk::now() - t).count();
+		printf("%s V=%u E=%u: tarjan %u components %.3fs, parallel %u components %.3fs\n",
+				kind == 0 ? "chain " : "random", N, (uint32_t)edges.size(), k1, s1, k2, s2);
+	}
 	return 0;
 }
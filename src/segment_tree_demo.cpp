@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include <assert.h>
+#include "segment_tree.h"
+
+using namespace alg;
+
+int main()
+{
+	int a[] = {5, 3, 8, 6, 1, 9, 2, 7};
+	const int N = sizeof(a) / sizeof(a[0]);
+
+	// point update, range min
+	SegmentTree<SegMin<int> > st(a, N);
+	printf("min [2, 6): %d\n", st.query(2, 6));
+	st.set(4, 10);
+	printf("after a[4] = 10, min [2, 6): %d\n", st.query(2, 6));
+	assert(st.query(2, 6) == 6);
+
+	// range add, range sum
+	LazySegmentTree<RangeAddSum<long long> > sum(N);
+	sum.apply(0, N, 1);
+	sum.apply(2, 5, 10);
+	printf("sum [0, 8): %lld, sum [4, 6): %lld\n", sum.query(0, N), sum.query(4, 6));
+	assert(sum.query(0, N) == 8 + 30 && sum.query(4, 6) == 12);
+
+	// range assign, range max
+	LazySegmentTree<RangeAssignMax<int> > mx(a, N);
+	SegAssign<int> f;
+	f.set = true;
+	f.v = 0;
+	mx.apply(3, 7, f);
+	printf("after a[3..6] = 0, max [0, 8): %d, max [3, 7): %d\n", mx.query(0, N), mx.query(3, 7));
+	assert(mx.query(0, N) == 8 && mx.query(3, 7) == 0);
+	for (int i = 0; i < N; i++) printf("%d ", mx.get(i));
+	printf("\n");
+	return 0;
+}
@@ -1,6 +1,10 @@
 #include <iostream>
 #include <string>
+#include <vector>
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
 
 #include "suffix_array.h"
 
@@ -13,12 +17,26 @@ void print(string::iterator b, string::iterator e) {
 
 int main()
 {
+	// 16MB of bytes, zeros included, from a small alphabet: long repeats
+	const uint32_t n = 16 << 20;
+	vector<unsigned char> text(n);
+	for (uint32_t i = 0; i < n; i++) text[i] = rand() % 4 == 0 ? 0 : 'a' + rand() % 3;
+	vector<uint32_t> sarr(n), lcp(n);
+	clock_t t = clock();
+	sais(&text[0], n, &sarr[0]);
+	printf("SA-IS on %uMB: %.2fs\n", n >> 20, (double)(clock() - t) / CLOCKS_PER_SEC);
+	t = clock();
+	kasai(&text[0], n, &sarr[0], &lcp[0]);
+	printf("Kasai LCP: %.2fs\n", (double)(clock() - t) / CLOCKS_PER_SEC);
+	cout<<"type strings to sort their suffixs:"<<endl;
+
 	string str;
 	while(cin>>str) {
 		SuffixArray sa(str);
 		cout<<endl;
-		cout<<"sorted suffixs are:"<<endl;
+		cout<<"sorted suffixs, after the lcp with the previous one:"<<endl;
 		for(size_t i=0;i<str.size();i++) {
+			cout<<sa.lcp_at(i)<<"\t";
 			print(str.begin()+sa[i], str.end());
 			cout<<endl;
 		}
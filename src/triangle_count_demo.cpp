@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+#include "csr_graph.h"
+#include "triangle_count.h"
+using namespace alg;
+
+static double now() { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main(void)
+{
+	srand(time(NULL));
+
+	// N/3 disjoint triangles, plus random chords
+	const uint32_t N = 300000, M = 3000000;
+	std::vector<WeightedEdge> edges;
+	for (uint32_t u = 0; u + 2 < N; u += 3) {
+		WeightedEdge a = {u, u + 1, 1}, b = {u + 1, u + 2, 1}, c = {u + 2, u, 1};
+		edges.push_back(a);
+		edges.push_back(b);
+		edges.push_back(c);
+	}
+	for (uint32_t i = 0; i < M; i++) {
+		WeightedEdge e = {(uint32_t)(rand() % N), (uint32_t)(rand() % N), 1};
+		edges.push_back(e);
+	}
+	CSRGraph g(N, &edges[0], (uint32_t)edges.size());
+
+	double t = now();
+	uint64_t n1 = triangle_count(g, 1);
+	printf("V=%u E=%u: %llu triangles, %.2fs on 1 thread\n", g.vertex_count(), g.edge_count(),
+			(unsigned long long)n1, now() - t);
+	t = now();
+	uint64_t n = triangle_count(g);
+	printf("%llu triangles, %.2fs CPU on all threads\n", (unsigned long long)n, now() - t);
+	return n == n1 ? 0 : 1;
+}